@@ -1,10 +1,31 @@
 #include <iostream>
 #include <iomanip>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
 using namespace std;
 
 #include <stdint.h>
+#include <stdlib.h>
 
 #include "crc16_ecc240.h"
+#include "crc16_ecc240_parallel.h"
+#include "crc16_ecc240_scrub.h"
+#include "crc16_ecc240_stream.h"
+#include "crc16_ecc240_interleave.h"
+#include "crc16_ecc240_outer.h"
+#include "crc16_ecc240_soft.h"
+#include "crc16_ecc240_long.h"
+#include "crc16_ecc240_dual.h"
+#include "crc16_ecc240_trace.h"
+#include "crc16_ecc240_udp.h"
+#include "crc16_ecc240_ring.h"
+#include "crc16_ecc240_pool.h"
+#include "crc16_ecc240_channel.h"
+#include "crc16_ecc240_policy.h"
+#include "crc16_ecc240_batcher.h"
 
 
 static void test_get_error(uint16_t crc, int bytes, int& errorOffset, uint16_t& errorSyndrome)
@@ -39,9 +60,2213 @@ static void test_get_error(uint16_t crc, int bytes, int& errorOffset, uint16_t&
 }
 
 
+// Flip every bit of a codeword in turn, including the CRC field
+static void test_codeword()
+{
+    static const int TotalBytes = CRC16_ECC240_MAX_CODEWORD_BYTES;
+
+    uint8_t frame[TotalBytes];
+    for (int i = 0; i < TotalBytes - 2; ++i)
+    {
+        frame[i] = (uint8_t)(i * 7 + 1);
+    }
+    crc16_ecc240_encode_codeword(frame, TotalBytes);
+
+    if (0 != crc16_ecc240_check_codeword(frame, TotalBytes))
+    {
+        cout << "FAILURE: Clean codeword rejected" << endl;
+        exit(4);
+    }
+
+    for (int j = 0; j < TotalBytes * 8; ++j)
+    {
+        uint8_t modified_frame[TotalBytes];
+        memcpy(modified_frame, frame, TotalBytes);
+        modified_frame[j / 8] ^= 1 << (j % 8);
+
+        if (0 != crc16_ecc240_check_codeword(modified_frame, TotalBytes) ||
+            0 != memcmp(frame, modified_frame, TotalBytes))
+        {
+            cout << "FAILURE: Could not correct the codeword error" << endl;
+            exit(4);
+        }
+
+        // Split form: Errors in the CRC field must leave the data untouched
+        memcpy(modified_frame, frame, TotalBytes);
+        modified_frame[j / 8] ^= 1 << (j % 8);
+        uint16_t received_crc = ((uint16_t)modified_frame[TotalBytes - 2] << 8) | modified_frame[TotalBytes - 1];
+
+        if (0 != crc16_ecc240_check(modified_frame, TotalBytes - 2, received_crc) ||
+            0 != memcmp(frame, modified_frame, TotalBytes - 2))
+        {
+            cout << "FAILURE: Could not correct the split form error" << endl;
+            exit(4);
+        }
+    }
+}
+
+// Verify a batch of frames with a few corrupted ones mixed in
+static void test_verify_many()
+{
+    static const int TotalBytes = CRC16_ECC240_MAX_CODEWORD_BYTES;
+    static const int Count = 1000;
+    static const size_t Stride = 48; // Frames need not be packed
+
+    uint8_t* frames = new uint8_t[Count * Stride];
+    uint64_t bitmap[(Count + 63) / 64];
+
+    for (int i = 0; i < Count; ++i)
+    {
+        uint8_t* frame = frames + i * Stride;
+        for (int j = 0; j < TotalBytes - 2; ++j)
+        {
+            frame[j] = (uint8_t)(i * 31 + j);
+        }
+        crc16_ecc240_encode_codeword(frame, TotalBytes);
+    }
+
+    // Single bit errors in every 7th frame, two bit errors in every 101st
+    for (int i = 0; i < Count; i += 7)
+    {
+        frames[i * Stride + (i % TotalBytes)] ^= 0x10;
+    }
+    for (int i = 0; i < Count; i += 101)
+    {
+        frames[i * Stride + 3] ^= 0x81;
+    }
+
+    int flagged = crc16_ecc240_verify_many(frames, TotalBytes, Stride, Count, bitmap);
+    int remaining = crc16_ecc240_correct_many(frames, TotalBytes, Stride, Count, bitmap);
+
+    int expectedFlagged = 0, expectedRemaining = 0;
+    for (int i = 0; i < Count; ++i)
+    {
+        bool single = (i % 7) == 0, multi = (i % 101) == 0;
+        expectedFlagged += (single || multi) ? 1 : 0;
+        expectedRemaining += multi ? 1 : 0;
+
+        bool bit = ((bitmap[i / 64] >> (i % 64)) & 1) != 0;
+        if (bit != multi)
+        {
+            cout << "FAILURE: Bulk verification bitmap mismatch" << endl;
+            exit(5);
+        }
+    }
+
+    if (flagged != expectedFlagged || remaining != expectedRemaining)
+    {
+        cout << "FAILURE: Bulk verification counts mismatch" << endl;
+        exit(5);
+    }
+
+    delete[] frames;
+}
+
+// Check a large array across the worker pool
+static void test_parallel()
+{
+    static const int TotalBytes = CRC16_ECC240_MAX_CODEWORD_BYTES;
+    static const size_t Count = 100000;
+
+    uint8_t* frames = new uint8_t[Count * TotalBytes];
+    uint64_t* bitmap = new uint64_t[(Count + 63) / 64];
+
+    for (size_t i = 0; i < Count * TotalBytes; ++i)
+    {
+        frames[i] = (uint8_t)(i * 13);
+    }
+    crc16_ecc240_encode_parallel(frames, TotalBytes, TotalBytes, Count);
+
+    // One single bit error per 1000 frames, one double bit error per 10000
+    for (size_t i = 0; i < Count; i += 1000)
+    {
+        frames[i * TotalBytes + 5] ^= 0x04;
+    }
+    for (size_t i = 500; i < Count; i += 10000)
+    {
+        frames[i * TotalBytes + 9] ^= 0x03;
+    }
+
+    crc16_ecc240_counts_t counts;
+    crc16_ecc240_check_parallel(frames, TotalBytes, TotalBytes, Count, &counts, bitmap);
+
+    if (counts.Corrected != Count / 1000 || counts.Failed != Count / 10000 ||
+        counts.Clean != Count - Count / 1000 - Count / 10000 ||
+        ((bitmap[500 / 64] >> (500 % 64)) & 1) == 0)
+    {
+        cout << "FAILURE: Parallel check counts mismatch" << endl;
+        exit(6);
+    }
+
+    // Split CRCs merge to the serial result
+    const size_t bytes = Count * TotalBytes;
+    const uint16_t serial = crc16_ecc240_generate(frames, (int)bytes);
+
+    for (size_t split = 0; split <= bytes; split += 400006)
+    {
+        uint16_t crcA = crc16_ecc240_generate(frames, (int)split);
+        uint16_t crcB = crc16_ecc240_generate(frames + split, (int)(bytes - split));
+        if (crc16_ecc240_combine(crcA, crcB, bytes - split) != serial)
+        {
+            cout << "FAILURE: Combined CRC mismatch" << endl;
+            exit(6);
+        }
+    }
+
+    if (crc16_ecc240_generate_parallel(frames, bytes) != serial ||
+        crc16_ecc240_generate_parallel(frames, 1000) != crc16_ecc240_generate(frames, 1000))
+    {
+        cout << "FAILURE: Parallel generate mismatch" << endl;
+        exit(6);
+    }
+
+    // A restarted pool must not run a stale task.  New workers look at the
+    // generation as soon as they start, so each restart exercises this
+    for (int restart = 0; restart < 20; ++restart)
+    {
+        crc16_ecc240_parallel_shutdown();
+        if (crc16_ecc240_parallel_init(4) != 0)
+        {
+            cout << "FAILURE: Parallel init after shutdown failed" << endl;
+            exit(6);
+        }
+
+        // Each worker runs the task exactly once
+        atomic<int> runs[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            runs[i] = 0;
+        }
+        crc16ecc240::ParallelRun([&runs](int index, int) {
+            runs[index].fetch_add(1);
+        });
+        for (int i = 0; i < 4; ++i)
+        {
+            if (runs[i].load() != 1)
+            {
+                cout << "FAILURE: Restarted pool ran a task " << runs[i].load() << " times" << endl;
+                exit(6);
+            }
+        }
+    }
+
+    crc16_ecc240_encode_parallel(frames, TotalBytes, TotalBytes, Count);
+    crc16_ecc240_check_parallel(frames, TotalBytes, TotalBytes, Count, &counts, bitmap);
+    if (counts.Clean != Count)
+    {
+        cout << "FAILURE: Restarted pool results mismatch" << endl;
+        exit(6);
+    }
+
+    delete[] frames;
+    delete[] bitmap;
+}
+
+// Split a frame into fragments at every possible pair of cut points
+static void test_iov()
+{
+    static const int DataLength = 30;
+
+    uint8_t data[DataLength];
+    for (int i = 0; i < DataLength; ++i)
+    {
+        data[i] = (uint8_t)(i * 11 + 3);
+    }
+    const uint16_t crc = crc16_ecc240_generate(data, DataLength);
+
+    for (int a = 0; a <= DataLength; ++a)
+    {
+        for (int b = a; b <= DataLength; ++b)
+        {
+            uint8_t copy[DataLength];
+            memcpy(copy, data, DataLength);
+
+            crc16_ecc240_iovec_t iov[3] = {
+                { copy, (size_t)a }, { copy + a, (size_t)(b - a) }, { copy + b, (size_t)(DataLength - b) }
+            };
+
+            if (crc16_ecc240_generate_iov(iov, 3) != crc)
+            {
+                cout << "FAILURE: Scatter-gather CRC mismatch" << endl;
+                exit(8);
+            }
+
+            // Flip a bit that moves with the cut points
+            int j = (a * 8 + b) % (DataLength * 8);
+            copy[j / 8] ^= 1 << (j % 8);
+
+            if (0 != crc16_ecc240_check_iov(iov, 3, crc) || 0 != memcmp(copy, data, DataLength))
+            {
+                cout << "FAILURE: Scatter-gather correction failed" << endl;
+                exit(8);
+            }
+        }
+    }
+}
+
+// Frame a stream written in odd-sized pieces, corrupt it, and read it back
+static void test_stream()
+{
+    static const size_t StreamBytes = 10007;
+    static const size_t MaxFrames = StreamBytes / CRC16_ECC240_STREAM_PAYLOAD_BYTES + 2;
+
+    uint8_t* stream = new uint8_t[StreamBytes];
+    for (size_t i = 0; i < StreamBytes; ++i)
+    {
+        stream[i] = (uint8_t)(i * 17 + (i >> 8));
+    }
+
+    // Two output buffers with slack that cannot hold a whole frame
+    uint8_t* wire = new uint8_t[MaxFrames * CRC16_ECC240_STREAM_FRAME_BYTES + 64];
+    size_t frameCount = 0;
+
+    crc16_ecc240_framer_t framer;
+    crc16_ecc240_framer_init(&framer);
+
+    for (size_t offset = 0, piece = 1; offset < StreamBytes; piece = piece * 3 % 101 + 1)
+    {
+        if (piece > StreamBytes - offset)
+        {
+            piece = StreamBytes - offset;
+        }
+
+        uint8_t* next = wire + frameCount * CRC16_ECC240_STREAM_FRAME_BYTES;
+        crc16_ecc240_iovec_t out[2] = {
+            { next, 2 * CRC16_ECC240_STREAM_FRAME_BYTES + 5 },
+            { next + 2 * CRC16_ECC240_STREAM_FRAME_BYTES, 4 * CRC16_ECC240_STREAM_FRAME_BYTES }
+        };
+        size_t written = 0;
+        size_t consumed = crc16_ecc240_framer_write(&framer, stream + offset, piece, out, 2, &written);
+
+        // The second buffer is only used once the first is full, so frames
+        // end up back to back
+        frameCount += written;
+        offset += consumed;
+    }
+    frameCount += crc16_ecc240_framer_flush(&framer, wire + frameCount * CRC16_ECC240_STREAM_FRAME_BYTES);
+
+    // Flip one bit in every fifth frame
+    for (size_t i = 0; i < frameCount; i += 5)
+    {
+        wire[i * CRC16_ECC240_STREAM_FRAME_BYTES + (i % CRC16_ECC240_STREAM_FRAME_BYTES)] ^= 0x40;
+    }
+
+    crc16_ecc240_iovec_t* payloads = new crc16_ecc240_iovec_t[frameCount];
+    if (0 != crc16_ecc240_deframe(wire, frameCount, payloads))
+    {
+        cout << "FAILURE: Deframing failed" << endl;
+        exit(7);
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        if (offset + payloads[i].Bytes > StreamBytes ||
+            0 != memcmp(stream + offset, payloads[i].Data, payloads[i].Bytes))
+        {
+            cout << "FAILURE: Deframed stream mismatch" << endl;
+            exit(7);
+        }
+        offset += payloads[i].Bytes;
+    }
+    if (offset != StreamBytes)
+    {
+        cout << "FAILURE: Deframed stream length mismatch" << endl;
+        exit(7);
+    }
+
+    delete[] stream;
+    delete[] wire;
+    delete[] payloads;
+}
+
+// Interleave frames, hit the wire with a long burst and recover every frame
+static void test_interleave()
+{
+    static const int Depths[3] = { 8, 16, 48 };
+    static const int FrameSizes[2] = { 30, 32 };
+
+    for (int d = 0; d < 3; ++d)
+    {
+        for (int f = 0; f < 2; ++f)
+        {
+            const int depth = Depths[d], frameBytes = FrameSizes[f];
+            const int bytes = depth * frameBytes;
+
+            uint8_t* frames = new uint8_t[bytes];
+            uint8_t* wire = new uint8_t[bytes];
+            uint8_t* received = new uint8_t[bytes];
+
+            for (int i = 0; i < depth; ++i)
+            {
+                for (int j = 0; j < frameBytes - 2; ++j)
+                {
+                    frames[i * frameBytes + j] = (uint8_t)(i * 57 + j * 5 + depth);
+                }
+                crc16_ecc240_encode_codeword(frames + i * frameBytes, frameBytes);
+            }
+
+            crc16_ecc240_interleave(frames, frameBytes, depth, wire);
+
+            // Check against the definition one bit at a time
+            for (int t = 0; t < bytes * 8; ++t)
+            {
+                int frame = t % depth, bit = t / depth;
+                int expected = (frames[frame * frameBytes + bit / 8] >> (7 - bit % 8)) & 1;
+                if (((wire[t / 8] >> (7 - t % 8)) & 1) != expected)
+                {
+                    cout << "FAILURE: Interleaved bit mismatch" << endl;
+                    exit(9);
+                }
+            }
+
+            // A burst as long as the depth
+            for (int t = 3 * depth + 5; t < 4 * depth + 5; ++t)
+            {
+                wire[t / 8] ^= 1 << (7 - t % 8);
+            }
+
+            crc16_ecc240_deinterleave(wire, frameBytes, depth, received);
+
+            for (int i = 0; i < depth; ++i)
+            {
+                if (0 != crc16_ecc240_check_codeword(received + i * frameBytes, frameBytes))
+                {
+                    cout << "FAILURE: Burst not corrected after deinterleave" << endl;
+                    exit(9);
+                }
+            }
+            if (0 != memcmp(frames, received, bytes))
+            {
+                cout << "FAILURE: Deinterleaved frames mismatch" << endl;
+                exit(9);
+            }
+
+            delete[] frames;
+            delete[] wire;
+            delete[] received;
+        }
+    }
+}
+
+
+static void test_outer()
+{
+    const int K = 20, M = 4, N = 32;
+
+    uint8_t data[K * N], parity[M * N], original[K * N];
+
+    for (int j = 0; j < K; ++j)
+    {
+        for (int k = 0; k < N - 2; ++k)
+        {
+            data[j * N + k] = (uint8_t)(j * 91 + k * 13 + 7);
+        }
+        crc16_ecc240_encode_codeword(data + j * N, N);
+    }
+    memcpy(original, data, sizeof(data));
+
+    crc16_ecc240_outer_encode(data, K, parity, M, N);
+
+    // The first parity frame is plain XOR parity
+    for (int k = 0; k < N - 2; ++k)
+    {
+        uint8_t x = 0;
+        for (int j = 0; j < K; ++j)
+        {
+            x ^= data[j * N + k];
+        }
+        if (parity[k] != x)
+        {
+            cout << "FAILURE: First parity frame is not XOR parity" << endl;
+            exit(10);
+        }
+    }
+
+    // Lose up to M frames in total, some of them parity
+    for (int lost = 1; lost <= M; ++lost)
+    {
+        for (int trial = 0; trial < 50; ++trial)
+        {
+            uint8_t p[M * N];
+            memcpy(p, parity, sizeof(p));
+            memcpy(data, original, sizeof(data));
+
+            const int lostParity = trial % lost;
+            for (int e = 0; e < lost - lostParity; ++e)
+            {
+                memset(data + ((trial * 7 + e * 5) % K) * N, 0x5a, N);
+            }
+            for (int e = 0; e < lostParity; ++e)
+            {
+                memset(p + ((trial + e) % M) * N, 0xa5, N);
+            }
+
+            // One extra single-bit error is corrected without using parity
+            data[((trial * 7 + 2) % K) * N + 3] ^= 0x10;
+
+            int result = crc16_ecc240_outer_decode(data, K, p, M, N);
+            if (result < 0 || 0 != memcmp(data, original, sizeof(data)))
+            {
+                cout << "FAILURE: Outer code did not rebuild lost frames" << endl;
+                exit(10);
+            }
+        }
+    }
+
+    // Too many losses
+    memcpy(data, original, sizeof(data));
+    for (int e = 0; e < M + 1; ++e)
+    {
+        memset(data + e * N, 0x5a, N);
+    }
+    if (crc16_ecc240_outer_decode(data, K, parity, M, N) != -1)
+    {
+        cout << "FAILURE: Outer code accepted too many losses" << endl;
+        exit(10);
+    }
+}
+
+
+static void test_soft()
+{
+    const int N = 32, Bits = N * 8;
+
+    uint8_t original[N], frame[N], reliability[Bits];
+
+    for (int trial = 0; trial < 200; ++trial)
+    {
+        for (int k = 0; k < N - 2; ++k)
+        {
+            original[k] = (uint8_t)(trial * 29 + k * 101);
+        }
+        crc16_ecc240_encode_codeword(original, N);
+        memcpy(frame, original, N);
+
+        // Strong bits everywhere, with a handful of weak decoys
+        memset(reliability, 200, sizeof(reliability));
+        for (int i = 0; i < 8; ++i)
+        {
+            reliability[(trial * 13 + i * 31) % Bits] = (uint8_t)(10 + i);
+        }
+
+        // Three errors on weak bits: Beyond the hard decoder
+        for (int i = 0; i < 3; ++i)
+        {
+            int p = (trial * 13 + i * 2 * 31) % Bits;
+            frame[p / 8] ^= (uint8_t)(0x80 >> (p % 8));
+        }
+
+        if (crc16_ecc240_check_soft(frame, N, reliability, 3, 256) != 3 ||
+            0 != memcmp(frame, original, N))
+        {
+            cout << "FAILURE: Soft decoder missed weak-bit errors" << endl;
+            exit(11);
+        }
+
+        // One weak error plus one strong error found by the hard decoder
+        int weakBit = (trial * 13 + 31) % Bits;
+        int strongBit = (weakBit + 97) % Bits;
+        frame[weakBit / 8] ^= (uint8_t)(0x80 >> (weakBit % 8));
+        frame[strongBit / 8] ^= (uint8_t)(0x80 >> (strongBit % 8));
+
+        if (crc16_ecc240_check_soft(frame, N, reliability, 2, 64) != 2 ||
+            0 != memcmp(frame, original, N))
+        {
+            cout << "FAILURE: Soft decoder missed weak plus strong error" << endl;
+            exit(11);
+        }
+
+        // With a single flip allowed it behaves like the hard decoder
+        frame[strongBit / 8] ^= (uint8_t)(0x80 >> (strongBit % 8));
+        if (crc16_ecc240_check_soft(frame, N, reliability, 1, 1) != 1 ||
+            0 != memcmp(frame, original, N))
+        {
+            cout << "FAILURE: Soft decoder missed single error" << endl;
+            exit(11);
+        }
+
+        frame[weakBit / 8] ^= (uint8_t)(0x80 >> (weakBit % 8));
+        frame[strongBit / 8] ^= (uint8_t)(0x80 >> (strongBit % 8));
+        uint8_t received[N];
+        memcpy(received, frame, N);
+        if (crc16_ecc240_check_soft(frame, N, reliability, 1, 1) != -1 ||
+            0 != memcmp(frame, received, N))
+        {
+            cout << "FAILURE: Soft decoder changed an uncorrectable frame" << endl;
+            exit(11);
+        }
+    }
+}
+
+
+static void test_long()
+{
+    const int Bytes = CRC16_ECC240_LONG_MAX_DATA_BYTES;
+
+    uint8_t* original = new uint8_t[Bytes];
+    uint8_t* data = new uint8_t[Bytes];
+
+    for (int i = 0; i < Bytes; ++i)
+    {
+        original[i] = (uint8_t)(i * 7 + (i >> 8));
+    }
+    memcpy(data, original, Bytes);
+
+    const uint16_t crc = crc16_ecc240_long_generate(original, Bytes);
+
+    for (int bit = 0; bit < (Bytes + 2) * 8; bit += 97)
+    {
+        uint16_t receivedCRC = crc;
+        if (bit < Bytes * 8)
+        {
+            data[bit / 8] ^= (uint8_t)(0x80 >> (bit % 8));
+        }
+        else
+        {
+            receivedCRC ^= (uint16_t)(0x8000 >> (bit - Bytes * 8));
+        }
+
+        if (0 != crc16_ecc240_long_check(data, Bytes, receivedCRC) ||
+            0 != memcmp(data, original, Bytes))
+        {
+            cout << "FAILURE: Long frame error not corrected at bit " << bit << endl;
+            exit(12);
+        }
+    }
+
+    // A short frame rejects syndromes that point past its start
+    int rejected = 0;
+    for (int bit = 0; bit < 16; ++bit)
+    {
+        data[bit / 8] ^= (uint8_t)(0x80 >> (bit % 8));
+        data[(bit + 100) / 8] ^= (uint8_t)(0x80 >> ((bit + 100) % 8));
+        if (0 != crc16_ecc240_long_check(data, 30, crc16_ecc240_long_generate(original, 30)))
+        {
+            ++rejected;
+        }
+        memcpy(data, original, 30);
+    }
+    if (rejected == 0)
+    {
+        cout << "FAILURE: Long decoder never rejected a double error" << endl;
+        exit(12);
+    }
+
+    delete[] original;
+    delete[] data;
+}
+
+
+static void test_dual()
+{
+    const int Bytes = CRC16_ECC240_DUAL_MAX_DATA_BYTES;
+    const int Bits = Bytes * 8 + 32;
+
+    uint8_t original[Bytes], data[Bytes];
+    for (int i = 0; i < Bytes; ++i)
+    {
+        original[i] = (uint8_t)(i * 151 + 3);
+    }
+
+    // The high half is the usual CRC16, the low half a CRC16 over the second polynomial
+    const uint32_t crc = crc16_ecc240_dual_generate(original, Bytes);
+    uint32_t q = 0;
+    for (int i = 0; i < Bytes * 8 + 16; ++i)
+    {
+        uint32_t bit = (i < Bytes * 8) ? (original[i / 8] >> (7 - i % 8)) & 1 : 0;
+        q = (q << 1) | bit;
+        if (q & 0x10000)
+        {
+            q ^= CRC16_ECC240_DUAL_POLY;
+        }
+    }
+    if ((crc >> 16) != crc16_ecc240_generate(original, Bytes) || (crc & 0xffff) != q)
+    {
+        cout << "FAILURE: Dual CRC mismatch" << endl;
+        exit(13);
+    }
+
+    // Any one or two flipped bits, in the data or either CRC
+    for (int trial = 0; trial < 2000; ++trial)
+    {
+        const int a = (trial * 7919) % Bits;
+        const int b = (trial % 3 == 0) ? a : (a + 1 + trial * 31) % Bits;
+
+        memcpy(data, original, Bytes);
+        uint32_t receivedCRC = crc;
+        const int flips[2] = { a, b };
+        for (int k = (a == b) ? 1 : 0; k < 2; ++k)
+        {
+            if (flips[k] < Bytes * 8)
+            {
+                data[flips[k] / 8] ^= (uint8_t)(0x80 >> (flips[k] % 8));
+            }
+            else
+            {
+                receivedCRC ^= 0x80000000u >> (flips[k] - Bytes * 8);
+            }
+        }
+
+        if (0 != crc16_ecc240_dual_check(data, Bytes, receivedCRC) ||
+            0 != memcmp(data, original, Bytes))
+        {
+            cout << "FAILURE: Dual check missed bits " << a << " and " << b << endl;
+            exit(13);
+        }
+    }
+}
+
+
+// Decoder that accepts every frame unchanged
+static int trace_accept_all(void* context, uint8_t* frame, int frameBytes)
+{
+    (void)context;
+    (void)frame;
+    (void)frameBytes;
+    return 0;
+}
+
+static void test_trace()
+{
+    static const char* Path = "crc_test_trace.bin";
+    static const int N = 32;
+    static const int Records = 5000; // Enough to use the worker pool
+
+    crc16_ecc240_trace_writer_t writer;
+    if (0 != crc16_ecc240_trace_create(&writer, Path, N))
+    {
+        cout << "FAILURE: Could not create trace file" << endl;
+        exit(14);
+    }
+
+    // Every 4th frame clean, then one flipped bit, two flipped bits, and a
+    // frame whose CRC field is lost
+    for (int i = 0; i < Records; ++i)
+    {
+        uint8_t original[N], received[N];
+        for (int k = 0; k < N - 2; ++k)
+        {
+            original[k] = (uint8_t)(i * 17 + k);
+        }
+        crc16_ecc240_encode_codeword(original, N);
+        memcpy(received, original, N);
+
+        switch (i % 4)
+        {
+        case 1: received[i % 30] ^= 0x20; break;
+        case 2: received[3] ^= 0x81; break;
+        case 3: received[N - 1] ^= 0xff; received[N - 2] ^= 0xff; break;
+        }
+
+        if (0 != crc16_ecc240_trace_append(&writer, (uint64_t)i * 1000, original, received))
+        {
+            cout << "FAILURE: Could not append to trace file" << endl;
+            exit(14);
+        }
+    }
+    crc16_ecc240_trace_close(&writer);
+
+    crc16_ecc240_trace_counts_t counts;
+    if (0 != crc16_ecc240_trace_replay(Path, nullptr, nullptr, &counts) ||
+        counts.Clean != Records / 4 || counts.Corrected != Records / 4 ||
+        counts.Miscorrected != 0 || counts.Rejected != Records / 2)
+    {
+        cout << "FAILURE: Trace replay counts mismatch" << endl;
+        exit(14);
+    }
+
+    if (0 != crc16_ecc240_trace_replay(Path, trace_accept_all, nullptr, &counts) ||
+        counts.Clean != Records / 4 || counts.Miscorrected != Records * 3 / 4)
+    {
+        cout << "FAILURE: Trace replay missed miscorrections" << endl;
+        exit(14);
+    }
+
+    remove(Path);
+}
+
+
+// Counts the frames a UDP receiver forwards
+static void udp_forward(void* context, uint8_t* frames, size_t stride, int count, const uint64_t* dropped)
+{
+    (void)frames;
+    (void)stride;
+    uint64_t& forwarded = *(uint64_t*)context;
+    for (int i = 0; i < count; ++i)
+    {
+        if (((dropped[i / 64] >> (i % 64)) & 1) == 0)
+        {
+            ++forwarded;
+        }
+    }
+}
+
+static void test_udp()
+{
+    static const int N = 32, Count = 200;
+
+    crc16_ecc240_udp_t* receiver = crc16_ecc240_udp_open("127.0.0.1", 0, N, 64);
+    crc16_ecc240_udp_t* sender = crc16_ecc240_udp_open("127.0.0.1", 0, N, 1);
+    crc16_ecc240_udp_t* shortSender = crc16_ecc240_udp_open("127.0.0.1", 0, N - 2, 1);
+    if (!receiver || !sender || !shortSender)
+    {
+        cout << "Skipping UDP test: Loopback sockets unavailable" << endl;
+        crc16_ecc240_udp_close(receiver);
+        crc16_ecc240_udp_close(sender);
+        crc16_ecc240_udp_close(shortSender);
+        return;
+    }
+
+    const uint16_t port = crc16_ecc240_udp_port(receiver);
+    if (0 != crc16_ecc240_udp_connect(sender, "127.0.0.1", port) ||
+        0 != crc16_ecc240_udp_connect(shortSender, "127.0.0.1", port))
+    {
+        cout << "FAILURE: UDP connect failed" << endl;
+        exit(15);
+    }
+
+    // Clean frames, with a correctable frame every 10 and a lost one every 50
+    uint8_t frames[Count * N];
+    for (int i = 0; i < Count; ++i)
+    {
+        for (int k = 0; k < N - 2; ++k)
+        {
+            frames[i * N + k] = (uint8_t)(i * 3 + k);
+        }
+        crc16_ecc240_encode_codeword(frames + i * N, N);
+        if (i % 10 == 5) frames[i * N + 7] ^= 0x10;
+        if (i % 50 == 0) frames[i * N + 7] ^= 0x11;
+    }
+
+    if (crc16_ecc240_udp_send(sender, frames, N, Count) != Count ||
+        crc16_ecc240_udp_send(shortSender, frames, N, 1) != 1)
+    {
+        cout << "FAILURE: UDP send failed" << endl;
+        exit(15);
+    }
+
+    crc16_ecc240_udp_counts_t counts;
+    memset(&counts, 0, sizeof(counts));
+    uint64_t forwarded = 0;
+    int received = 0;
+    while (received < Count + 1)
+    {
+        int result = crc16_ecc240_udp_receive(receiver, 1000, udp_forward, &forwarded, &counts);
+        if (result <= 0)
+        {
+            break;
+        }
+        received += result;
+    }
+
+    if (received != Count + 1 || counts.Corrected != Count / 10 || counts.Failed != Count / 50 ||
+        counts.Malformed != 1 || counts.Clean != Count - Count / 10 - Count / 50 ||
+        forwarded != counts.Clean + counts.Corrected)
+    {
+        cout << "FAILURE: UDP receive counts mismatch" << endl;
+        exit(15);
+    }
+
+    // A short datagram alone is dropped without touching the library stats
+    crc16_ecc240_stats_t before, after;
+    crc16_ecc240_stats_snapshot(&before);
+    memset(&counts, 0, sizeof(counts));
+    forwarded = 0;
+    if (crc16_ecc240_udp_send(shortSender, frames + N, N, 1) != 1 ||
+        crc16_ecc240_udp_receive(receiver, 1000, udp_forward, &forwarded, &counts) != 1)
+    {
+        cout << "FAILURE: UDP short datagram not received" << endl;
+        exit(15);
+    }
+    crc16_ecc240_stats_snapshot(&after);
+    if (counts.Malformed != 1 || counts.Clean + counts.Corrected + counts.Failed != 0 || forwarded != 0 ||
+        after.Clean != before.Clean || after.Corrected != before.Corrected ||
+        after.Uncorrectable != before.Uncorrectable || after.Miscorrected != before.Miscorrected)
+    {
+        cout << "FAILURE: UDP short datagram reached the decoder" << endl;
+        exit(15);
+    }
+
+    crc16_ecc240_udp_close(receiver);
+    crc16_ecc240_udp_close(sender);
+    crc16_ecc240_udp_close(shortSender);
+}
+
+
+// Checks that ring frames arrive in order
+struct RingTestState
+{
+    uint32_t Next;
+    uint64_t Failed;
+};
+
+static void ring_test_deliver(void* context, uint8_t* frames, int count, const uint64_t* failed)
+{
+    RingTestState& state = *(RingTestState*)context;
+    for (int i = 0; i < count; ++i)
+    {
+        const uint8_t* frame = frames + i * CRC16_ECC240_RING_SLOT_BYTES;
+        uint32_t sequence;
+        memcpy(&sequence, frame, 4);
+        if (sequence != state.Next++)
+        {
+            cout << "FAILURE: Ring frames out of order" << endl;
+            exit(16);
+        }
+        state.Failed += (failed[i / 64] >> (i % 64)) & 1;
+    }
+}
+
+static void test_ring()
+{
+    static const int N = CRC16_ECC240_RING_SLOT_BYTES;
+    static const uint32_t Count = 100000;
+
+    crc16_ecc240_ring_t* ring = crc16_ecc240_ring_create(1000);
+
+    // A producer thread fills the small ring far faster than it drains
+    thread producer([&]() {
+        uint32_t sequence = 0;
+        while (sequence < Count)
+        {
+            size_t reserved;
+            uint8_t* slots = crc16_ecc240_ring_write_begin(ring, 64, &reserved);
+            if (reserved == 0)
+            {
+                this_thread::yield(); // Backpressure
+                continue;
+            }
+            if (reserved > Count - sequence)
+            {
+                reserved = Count - sequence;
+            }
+            for (size_t i = 0; i < reserved; ++i, ++sequence)
+            {
+                uint8_t* frame = slots + i * N;
+                memset(frame, 0x33, N);
+                memcpy(frame, &sequence, 4);
+                crc16_ecc240_encode_codeword(frame, N);
+                if (sequence % 100 == 7) frame[10] ^= 0x02;
+            }
+            crc16_ecc240_ring_write_commit(ring, reserved);
+        }
+    });
+
+    RingTestState state;
+    state.Next = 0;
+    state.Failed = 0;
+    crc16_ecc240_counts_t counts;
+    memset(&counts, 0, sizeof(counts));
+
+    while (state.Next < Count)
+    {
+        if (0 == crc16_ecc240_ring_check(ring, N, 256, ring_test_deliver, &state, &counts))
+        {
+            this_thread::yield();
+        }
+    }
+    producer.join();
+
+    if (counts.Corrected != Count / 100 || counts.Failed != 0 || state.Failed != 0 ||
+        counts.Clean != Count - Count / 100)
+    {
+        cout << "FAILURE: Ring check counts mismatch" << endl;
+        exit(16);
+    }
+
+    crc16_ecc240_ring_destroy(ring);
+}
+
+static void test_pool()
+{
+    static const int Sizes[2] = { 30, 20 };
+
+    for (int s = 0; s < 2; ++s)
+    {
+        const int dataBytes = Sizes[s];
+        crc16_ecc240_pool_t* pool = crc16_ecc240_pool_create(dataBytes);
+        crc16_ecc240_block_t* block = crc16_ecc240_pool_alloc(pool);
+
+        if ((uintptr_t)block->Data % 64 != 0 || block->Count != 0)
+        {
+            cout << "FAILURE: Pool block not aligned" << endl;
+            exit(17);
+        }
+
+        // A partial last bitmap word
+        block->Count = block->Capacity - 3;
+        for (int i = 0; i < block->Count * CRC16_ECC240_BLOCK_SLOT_BYTES; ++i)
+        {
+            block->Data[i] = (uint8_t)(i * 31 + s);
+        }
+        crc16_ecc240_block_encode(block);
+
+        for (int i = 0; i < block->Count; ++i)
+        {
+            if (block->CRCs[i] != crc16_ecc240_generate(block->Data + i * CRC16_ECC240_BLOCK_SLOT_BYTES, dataBytes))
+            {
+                cout << "FAILURE: Block encode mismatch" << endl;
+                exit(17);
+            }
+        }
+
+        // Single-bit errors in data and CRCs, and one frame beyond repair
+        block->Data[5 * CRC16_ECC240_BLOCK_SLOT_BYTES + 3] ^= 0x10;
+        block->Data[100 * CRC16_ECC240_BLOCK_SLOT_BYTES + dataBytes - 1] ^= 0x01;
+        block->CRCs[70] ^= 0x8000;
+        block->Data[200 * CRC16_ECC240_BLOCK_SLOT_BYTES] ^= 0x03;
+        block->Data[200 * CRC16_ECC240_BLOCK_SLOT_BYTES + 9] ^= 0x40;
+
+        // Padding bytes are not part of the frame
+        block->Data[7 * CRC16_ECC240_BLOCK_SLOT_BYTES + 31] ^= 0xff;
+
+        uint64_t bitmap[CRC16_ECC240_POOL_BLOCK_FRAMES / 64];
+        if (crc16_ecc240_block_verify(block, bitmap) != 4 ||
+            bitmap[0] != ((uint64_t)1 << 5) ||
+            bitmap[1] != (((uint64_t)1 << (70 - 64)) | ((uint64_t)1 << (100 - 64))) ||
+            bitmap[3] != ((uint64_t)1 << (200 - 192)))
+        {
+            cout << "FAILURE: Block verify flagged the wrong frames" << endl;
+            exit(17);
+        }
+
+        if (crc16_ecc240_block_correct(block, bitmap) != 1 ||
+            bitmap[0] != 0 || bitmap[1] != 0 || bitmap[3] != ((uint64_t)1 << (200 - 192)) ||
+            block->CRCs[70] != crc16_ecc240_generate(block->Data + 70 * CRC16_ECC240_BLOCK_SLOT_BYTES, dataBytes) ||
+            block->Data[5 * CRC16_ECC240_BLOCK_SLOT_BYTES + 3] != (uint8_t)((5 * CRC16_ECC240_BLOCK_SLOT_BYTES + 3) * 31 + s))
+        {
+            cout << "FAILURE: Block correct mismatch" << endl;
+            exit(17);
+        }
+
+        // Freed blocks are reused
+        crc16_ecc240_pool_free(pool, block);
+        crc16_ecc240_block_t* again = crc16_ecc240_pool_alloc(pool);
+        crc16_ecc240_block_t* other = crc16_ecc240_pool_alloc(pool);
+        if (again != block || other == block || again->Count != 0)
+        {
+            cout << "FAILURE: Pool did not reuse the freed block" << endl;
+            exit(17);
+        }
+
+        crc16_ecc240_pool_destroy(pool);
+    }
+}
+
+static int count_bit_differences(const uint8_t* a, const uint8_t* b, size_t bytes)
+{
+    int count = 0;
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        for (uint8_t x = a[i] ^ b[i]; x; x &= x - 1)
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+
+static void test_channel()
+{
+    static const size_t Bytes = 1 << 20;
+    vector<uint8_t> zero(Bytes, 0), whole(Bytes, 0), chunked(Bytes, 0);
+
+    // Error count near the expected 8389 for 10^-3, and matches the return
+    crc16_ecc240_channel_t* bsc = crc16_ecc240_channel_bsc(0.001, 1);
+    uint64_t flips = crc16_ecc240_channel_apply(bsc, &whole[0], Bytes);
+    crc16_ecc240_channel_destroy(bsc);
+    if (flips != (uint64_t)count_bit_differences(&whole[0], &zero[0], Bytes) || flips < 7900 || flips > 8900)
+    {
+        cout << "FAILURE: BSC error count " << flips << endl;
+        exit(18);
+    }
+
+    // Bursts are exactly 10 bits from first to last flip, even across buffers
+    crc16_ecc240_channel_t* a = crc16_ecc240_channel_burst(0.0001, 10, 2);
+    crc16_ecc240_channel_t* b = crc16_ecc240_channel_burst(0.0001, 10, 2);
+    fill(whole.begin(), whole.end(), (uint8_t)0);
+    crc16_ecc240_channel_apply(a, &whole[0], Bytes);
+    for (size_t i = 0; i < Bytes; i += 7)
+    {
+        crc16_ecc240_channel_apply(b, &chunked[i], min((size_t)7, Bytes - i));
+    }
+    crc16_ecc240_channel_destroy(a);
+    crc16_ecc240_channel_destroy(b);
+    if (whole != chunked)
+    {
+        cout << "FAILURE: Channel stream depends on buffer boundaries" << endl;
+        exit(18);
+    }
+
+    int bursts = 0;
+    uint64_t first = 0, last = 0;
+    bool open = false;
+    for (uint64_t bit = 0; bit <= (uint64_t)Bytes * 8; ++bit)
+    {
+        const bool flipped = bit < (uint64_t)Bytes * 8 && (whole[bit / 8] & (0x80 >> (bit % 8)));
+        if (open && (flipped ? bit - first >= 10 : bit - last >= 10))
+        {
+            if (last - first != 9)
+            {
+                cout << "FAILURE: Burst of " << last - first + 1 << " bits" << endl;
+                exit(18);
+            }
+            ++bursts;
+            open = false;
+        }
+        if (flipped)
+        {
+            if (!open)
+            {
+                first = bit;
+                open = true;
+            }
+            last = bit;
+        }
+    }
+    if (bursts < 700 || bursts > 1000)
+    {
+        cout << "FAILURE: Burst count " << bursts << endl;
+        exit(18);
+    }
+
+    // Gilbert-Elliott: Bad 1% of the time with 10% errors there
+    crc16_ecc240_channel_t* ge = crc16_ecc240_channel_gilbert(0.0001, 0.01, 0., 0.1, 3);
+    fill(whole.begin(), whole.end(), (uint8_t)0);
+    flips = crc16_ecc240_channel_apply(ge, &whole[0], Bytes);
+    crc16_ecc240_channel_destroy(ge);
+    if (flips < 6500 || flips > 10500)
+    {
+        cout << "FAILURE: Gilbert-Elliott error count " << flips << endl;
+        exit(18);
+    }
+
+    // About 20% of 32-byte frames see exactly one error at 10^-3
+    static const uint64_t Frames = 100000;
+    crc16_ecc240_trace_counts_t counts;
+    memset(&counts, 0, sizeof(counts));
+    bsc = crc16_ecc240_channel_bsc(0.001, 4);
+    crc16_ecc240_channel_evaluate(bsc, CRC16_ECC240_MAX_CODEWORD_BYTES, Frames, nullptr, nullptr, &counts);
+    crc16_ecc240_channel_destroy(bsc);
+    if (counts.Clean + counts.Corrected + counts.Miscorrected + counts.Rejected != Frames ||
+        counts.Clean < 75000 || counts.Clean > 80000 || counts.Corrected < 18000)
+    {
+        cout << "FAILURE: Channel evaluation counts mismatch" << endl;
+        exit(18);
+    }
+
+    if (crc16_ecc240_channel_bsc(1.5, 0) != 0 || crc16_ecc240_channel_burst(0.1, 0, 0) != 0)
+    {
+        cout << "FAILURE: Channel accepted bad parameters" << endl;
+        exit(18);
+    }
+}
+
+static void test_constant()
+{
+    uint8_t frame[CRC16_ECC240_MAX_CODEWORD_BYTES];
+    uint8_t a[CRC16_ECC240_MAX_CODEWORD_BYTES], b[CRC16_ECC240_MAX_CODEWORD_BYTES];
+
+    for (int totalBytes = 4; totalBytes <= CRC16_ECC240_MAX_CODEWORD_BYTES; totalBytes += 2)
+    {
+        const int bytes = totalBytes - 2;
+        for (int i = 0; i < totalBytes; ++i)
+        {
+            frame[i] = (uint8_t)(i * 37 + totalBytes);
+        }
+        crc16_ecc240_encode_codeword(frame, totalBytes);
+
+        // Clean, every single-bit error, and pairs of errors
+        for (int bit = -1; bit < totalBytes * 8; ++bit)
+        {
+            for (int second = -1; second < totalBytes * 8; second += (bit < 0) ? 1 : 37)
+            {
+                memcpy(a, frame, totalBytes);
+                if (bit >= 0) a[bit / 8] ^= (uint8_t)(0x80 >> (bit % 8));
+                if (second >= 0 && second != bit) a[second / 8] ^= (uint8_t)(0x80 >> (second % 8));
+                memcpy(b, a, totalBytes);
+
+                // Codeword form against the variable-time check
+                const bool expected = (0 == crc16_ecc240_check_codeword(a, totalBytes));
+                const int result = crc16_ecc240_check_codeword_constant(b, totalBytes);
+                if ((result == 0) != expected || (result != 0 && result != -1) ||
+                    0 != memcmp(a, b, totalBytes))
+                {
+                    cout << "FAILURE: Constant-latency codeword check mismatch" << endl;
+                    exit(19);
+                }
+
+                // Split form, with the CRC taken from the damaged frame
+                memcpy(a, frame, totalBytes);
+                if (bit >= 0) a[bit / 8] ^= (uint8_t)(0x80 >> (bit % 8));
+                if (second >= 0 && second != bit) a[second / 8] ^= (uint8_t)(0x80 >> (second % 8));
+                memcpy(b, a, totalBytes);
+                const uint16_t received = (uint16_t)((a[bytes] << 8) | a[bytes + 1]);
+
+                const bool splitExpected = (0 == crc16_ecc240_check(a, bytes, received));
+                const int splitResult = crc16_ecc240_check_constant(b, bytes, received);
+                if ((splitResult == 0) != splitExpected || 0 != memcmp(a, b, bytes))
+                {
+                    cout << "FAILURE: Constant-latency check mismatch" << endl;
+                    exit(19);
+                }
+            }
+        }
+    }
+}
+
+// Send frames through a channel and check them under a policy
+static void policy_test_run(crc16_ecc240_policy_t* policy, crc16_ecc240_channel_t* channel, int batches)
+{
+    static const int N = CRC16_ECC240_MAX_CODEWORD_BYTES;
+    static const int Count = 256;
+    uint8_t frames[Count * N];
+    uint64_t bitmap[Count / 64];
+
+    for (int b = 0; b < batches; ++b)
+    {
+        for (int i = 0; i < Count * N; ++i)
+        {
+            frames[i] = (uint8_t)(i * 13 + b);
+        }
+        crc16_ecc240_encode_many(frames, N, N, Count);
+        crc16_ecc240_channel_apply(channel, frames, sizeof(frames));
+        crc16_ecc240_policy_check_many(policy, frames, N, N, Count, bitmap);
+    }
+}
+
+static void test_policy()
+{
+    static const int N = CRC16_ECC240_MAX_CODEWORD_BYTES;
+    uint8_t frame[N], copy[N];
+    for (int i = 0; i < N; ++i)
+    {
+        frame[i] = (uint8_t)(i * 29);
+    }
+    crc16_ecc240_encode_codeword(frame, N);
+
+    // Every burst of up to 3 bits is corrected
+    static const uint8_t Patterns[4] = { 1, 3, 5, 7 };
+    for (int p = 0; p < 4; ++p)
+    {
+        for (int start = 0; start + 3 <= N * 8; ++start)
+        {
+            memcpy(copy, frame, N);
+            for (int k = 0; k < 3; ++k)
+            {
+                if (Patterns[p] & (1 << k))
+                {
+                    copy[(start + k) / 8] ^= (uint8_t)(0x80 >> ((start + k) % 8));
+                }
+            }
+            if (0 != crc16_ecc240_check_burst(copy, N) || 0 != memcmp(copy, frame, N))
+            {
+                cout << "FAILURE: Burst not corrected" << endl;
+                exit(20);
+            }
+        }
+    }
+
+    crc16_ecc240_policy_config_t config;
+    config.MiscorrectionBudget = 1e-6;
+    config.MinFrames = 10000;
+    config.Decay = 0.;
+    config.InitialMode = CRC16_ECC240_POLICY_DETECT;
+    crc16_ecc240_policy_t* policy = crc16_ecc240_policy_create(&config);
+
+    // Sparse single-bit errors: Correcting them is safe and saves retransmits
+    crc16_ecc240_channel_t* channel = crc16_ecc240_channel_bsc(0.00002, 1);
+    policy_test_run(policy, channel, 100);
+    crc16_ecc240_channel_destroy(channel);
+    if (crc16_ecc240_policy_update(policy) != CRC16_ECC240_POLICY_SINGLE)
+    {
+        cout << "FAILURE: Policy did not enable single-bit correction" << endl;
+        exit(20);
+    }
+
+    // Two-bit bursts: Only burst correction avoids the retransmits
+    channel = crc16_ecc240_channel_burst(0.00002, 2, 2);
+    policy_test_run(policy, channel, 100);
+    crc16_ecc240_channel_destroy(channel);
+    if (crc16_ecc240_policy_update(policy) != CRC16_ECC240_POLICY_BURST)
+    {
+        cout << "FAILURE: Policy did not enable burst correction" << endl;
+        exit(20);
+    }
+
+    // Heavy random errors: Any correction would blow the miscorrection budget
+    channel = crc16_ecc240_channel_bsc(0.01, 3);
+    policy_test_run(policy, channel, 100);
+    crc16_ecc240_channel_destroy(channel);
+    if (crc16_ecc240_policy_update(policy) != CRC16_ECC240_POLICY_DETECT)
+    {
+        cout << "FAILURE: Policy did not fall back to detection" << endl;
+        exit(20);
+    }
+
+    crc16_ecc240_policy_counts_t counts;
+    crc16_ecc240_policy_counts(policy, &counts);
+    if (counts.Frames != 3 * 100 * 256 || counts.Single == 0 || counts.Burst == 0 ||
+        counts.Clean + counts.Single + counts.Burst + counts.Other != counts.Frames)
+    {
+        cout << "FAILURE: Policy counts mismatch" << endl;
+        exit(20);
+    }
+
+    // The single-frame path follows the mode in force
+    memcpy(copy, frame, N);
+    copy[3] ^= 0x10;
+    if (crc16_ecc240_policy_check(policy, copy, N) != -1)
+    {
+        cout << "FAILURE: Detect mode accepted a damaged frame" << endl;
+        exit(20);
+    }
+
+    crc16_ecc240_policy_destroy(policy);
+}
+
+struct BatcherTestFrame
+{
+    uint8_t Data[CRC16_ECC240_MAX_CODEWORD_BYTES];
+    int Result;
+    atomic<int>* Completed;
+};
+
+static void batcher_test_done(void* context, int result)
+{
+    BatcherTestFrame* frame = static_cast<BatcherTestFrame*>(context);
+    frame->Result = result;
+    frame->Completed->fetch_add(1);
+}
+
+static bool batcher_test_wait(atomic<int>& completed, int count, double timeoutSeconds)
+{
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while (completed.load() < count)
+    {
+        if (chrono::duration<double>(chrono::steady_clock::now() - start).count() > timeoutSeconds)
+        {
+            return false;
+        }
+        this_thread::sleep_for(chrono::microseconds(100));
+    }
+    return true;
+}
+
+#if defined(__cpp_impl_coroutine)
+
+// Coroutine that runs to completion without being awaited itself
+struct BatcherTestTask
+{
+    struct promise_type
+    {
+        BatcherTestTask get_return_object() { return BatcherTestTask(); }
+        std::suspend_never initial_suspend() noexcept { return std::suspend_never(); }
+        std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+        void return_void() {}
+        void unhandled_exception() { exit(21); }
+    };
+};
+
+// Encode a frame, damage one bit and check it, through co_await
+static BatcherTestTask batcher_test_coroutine(crc16_ecc240_batcher_t* batcher, uint8_t* frame,
+                                              int* crc, int* result, atomic<int>* completed)
+{
+    *crc = co_await crc16ecc240::AsyncGenerate(batcher, frame);
+    frame[3] ^= 0x40;
+    *result = co_await crc16ecc240::AsyncCheck(batcher, frame);
+    completed->fetch_add(1);
+}
+
+#endif // __cpp_impl_coroutine
+
+static void test_batcher()
+{
+    static const int N = CRC16_ECC240_MAX_CODEWORD_BYTES;
+    static const int Threads = 4;
+    static const int PerThread = 96;
+    static const int Count = Threads * PerThread;
+
+    vector<BatcherTestFrame> frames(Count);
+    uint8_t expected[Count][N];
+    atomic<int> completed(0);
+
+    // Alternate checks of damaged and clean codewords with generates
+    for (int i = 0; i < Count; ++i)
+    {
+        BatcherTestFrame& frame = frames[i];
+        for (int j = 0; j < N; ++j)
+        {
+            frame.Data[j] = (uint8_t)(i * 13 + j * 7);
+        }
+        crc16_ecc240_encode_codeword(frame.Data, N);
+        memcpy(expected[i], frame.Data, N);
+        if (i % 3 == 0)
+        {
+            frame.Data[(i / 3) % N] ^= (uint8_t)(1 << (i % 8));
+        }
+        else if (i % 3 == 2)
+        {
+            frame.Data[N - 2] = 0;
+            frame.Data[N - 1] = 0;
+        }
+        frame.Result = -2;
+        frame.Completed = &completed;
+    }
+
+    // A batch size that divides the load, and a delay too long to ever
+    // expire, so only full batches can complete the requests
+    crc16_ecc240_batcher_t* batcher = crc16_ecc240_batcher_create(N, 32, 60000000);
+    if (!batcher)
+    {
+        cout << "FAILURE: Batcher create failed" << endl;
+        exit(21);
+    }
+
+    vector<thread> submitters;
+    for (int t = 0; t < Threads; ++t)
+    {
+        submitters.push_back(thread([&frames, batcher, t]() {
+            for (int i = t * PerThread; i < (t + 1) * PerThread; ++i)
+            {
+                int r = (i % 3 == 2) ?
+                    crc16_ecc240_batcher_generate(batcher, frames[i].Data, batcher_test_done, &frames[i]) :
+                    crc16_ecc240_batcher_check(batcher, frames[i].Data, batcher_test_done, &frames[i]);
+                if (r != 0)
+                {
+                    cout << "FAILURE: Batcher rejected a request" << endl;
+                    exit(21);
+                }
+            }
+        }));
+    }
+    for (int t = 0; t < Threads; ++t)
+    {
+        submitters[t].join();
+    }
+
+    if (!batcher_test_wait(completed, Count, 5.))
+    {
+        cout << "FAILURE: Full batches were not flushed" << endl;
+        exit(21);
+    }
+
+    for (int i = 0; i < Count; ++i)
+    {
+        const int want = (i % 3 == 2) ? ((expected[i][N - 2] << 8) | expected[i][N - 1]) : 0;
+        if (frames[i].Result != want || 0 != memcmp(frames[i].Data, expected[i], N))
+        {
+            cout << "FAILURE: Batcher result mismatch at " << i << endl;
+            exit(21);
+        }
+    }
+
+    // A lone damaged frame is flushed by the deadline
+    crc16_ecc240_batcher_destroy(batcher);
+    batcher = crc16_ecc240_batcher_create(N, 1000, 2000);
+    completed = 0;
+    frames[0].Data[5] ^= 0x21;
+    crc16_ecc240_batcher_check(batcher, frames[0].Data, batcher_test_done, &frames[0]);
+    if (!batcher_test_wait(completed, 1, 1.) || frames[0].Result != -1)
+    {
+        cout << "FAILURE: Batcher deadline did not flush" << endl;
+        exit(21);
+    }
+
+    // Destroy completes whatever is still queued
+    crc16_ecc240_batcher_destroy(batcher);
+    batcher = crc16_ecc240_batcher_create(N, 1000, 60000000);
+    completed = 0;
+    for (int i = 1; i < 10; ++i)
+    {
+        crc16_ecc240_batcher_check(batcher, frames[i].Data, batcher_test_done, &frames[i]);
+    }
+    crc16_ecc240_batcher_destroy(batcher);
+    if (completed.load() != 9)
+    {
+        cout << "FAILURE: Batcher destroy dropped requests" << endl;
+        exit(21);
+    }
+
+#if defined(__cpp_impl_coroutine)
+    // Awaitables resume with each result in turn
+    batcher = crc16_ecc240_batcher_create(N, 8, 1000);
+    completed = 0;
+    uint8_t awaited[N], reference[N];
+    for (int i = 0; i < N; ++i)
+    {
+        awaited[i] = (uint8_t)(i * 31);
+    }
+    memcpy(reference, awaited, N);
+    crc16_ecc240_encode_codeword(reference, N);
+
+    int crc = -2, result = -2;
+    batcher_test_coroutine(batcher, awaited, &crc, &result, &completed);
+    if (!batcher_test_wait(completed, 1, 5.) || result != 0 ||
+        crc != ((reference[N - 2] << 8) | reference[N - 1]) || 0 != memcmp(awaited, reference, N))
+    {
+        cout << "FAILURE: Batcher awaitables mismatch" << endl;
+        exit(21);
+    }
+    crc16_ecc240_batcher_destroy(batcher);
+#endif // __cpp_impl_coroutine
+}
+
+static void test_classify()
+{
+    static const int Lengths[3] = { 4, 18, CRC16_ECC240_MAX_CODEWORD_BYTES };
+
+    for (int l = 0; l < 3; ++l)
+    {
+        const int N = Lengths[l];
+        const int bits = N * 8;
+        uint8_t frame[CRC16_ECC240_MAX_CODEWORD_BYTES], copy[CRC16_ECC240_MAX_CODEWORD_BYTES];
+        for (int i = 0; i < N; ++i)
+        {
+            frame[i] = (uint8_t)(i * 53 + l);
+        }
+        crc16_ecc240_encode_codeword(frame, N);
+
+        int position = 0;
+        if (crc16_ecc240_classify_codeword(frame, N, &position) != CRC16_ECC240_CLASS_CLEAN || position != -1)
+        {
+            cout << "FAILURE: Clean codeword misclassified" << endl;
+            exit(22);
+        }
+
+        for (int i = 0; i < bits; ++i)
+        {
+            // One bit: Classified by field and corrected
+            memcpy(copy, frame, N);
+            copy[i / 8] ^= (uint8_t)(0x80 >> (i % 8));
+            const int expected = (i < bits - 16) ? CRC16_ECC240_CLASS_DATA_BIT : CRC16_ECC240_CLASS_CRC_BIT;
+            if (crc16_ecc240_classify_codeword(copy, N, &position) != expected || position != i ||
+                crc16_ecc240_check_codeword(copy, N) != 0 || 0 != memcmp(copy, frame, N))
+            {
+                cout << "FAILURE: Single bit misclassified at " << i << endl;
+                exit(22);
+            }
+
+            if (i + 1 >= bits)
+            {
+                continue;
+            }
+
+            // Two neighboring bits: Classified but left for the caller
+            memcpy(copy, frame, N);
+            copy[i / 8] ^= (uint8_t)(0x80 >> (i % 8));
+            copy[(i + 1) / 8] ^= (uint8_t)(0x80 >> ((i + 1) % 8));
+            if (crc16_ecc240_classify_codeword(copy, N, &position) != CRC16_ECC240_CLASS_ADJACENT ||
+                position != i || crc16_ecc240_check_codeword(copy, N) != -1)
+            {
+                cout << "FAILURE: Adjacent pair misclassified at " << i << endl;
+                exit(22);
+            }
+
+            // The split form agrees
+            if (i + 1 < bits - 16 &&
+                crc16_ecc240_check(copy, N - 2, (uint16_t)((copy[N - 2] << 8) | copy[N - 1])) != -1)
+            {
+                cout << "FAILURE: Split check accepted an adjacent pair" << endl;
+                exit(22);
+            }
+
+            if (i + 2 >= bits)
+            {
+                continue;
+            }
+
+            // Three-bit bursts 101 and 111
+            for (int burst = 0; burst < 2; ++burst)
+            {
+                memcpy(copy, frame, N);
+                copy[i / 8] ^= (uint8_t)(0x80 >> (i % 8));
+                copy[(i + 2) / 8] ^= (uint8_t)(0x80 >> ((i + 2) % 8));
+                if (burst == 1)
+                {
+                    copy[(i + 1) / 8] ^= (uint8_t)(0x80 >> ((i + 1) % 8));
+                }
+                const int expected = burst ? CRC16_ECC240_CLASS_TRIPLE : CRC16_ECC240_CLASS_SPLIT;
+                if (crc16_ecc240_classify_codeword(copy, N, &position) != expected ||
+                    position != i || crc16_ecc240_check_codeword(copy, N) != -1)
+                {
+                    cout << "FAILURE: Three-bit burst misclassified at " << i << endl;
+                    exit(22);
+                }
+            }
+        }
+
+        // Random damage is only ever corrected when classified as one bit
+        for (int trial = 0; trial < 10000; ++trial)
+        {
+            memcpy(copy, frame, N);
+            const int flips = 2 + trial % 5;
+            for (int k = 0; k < flips; ++k)
+            {
+                const int bit = (trial * 7919 + k * 104729 + (trial >> 3) * k) % bits;
+                copy[bit / 8] ^= (uint8_t)(0x80 >> (bit % 8));
+            }
+
+            const int errorClass = crc16_ecc240_classify_codeword(copy, N, &position);
+            const bool single = (errorClass == CRC16_ECC240_CLASS_DATA_BIT || errorClass == CRC16_ECC240_CLASS_CRC_BIT);
+            const int result = crc16_ecc240_check_codeword(copy, N);
+            if ((result == 0) != (single || errorClass == CRC16_ECC240_CLASS_CLEAN) ||
+                (errorClass == CRC16_ECC240_CLASS_UNCORRECTABLE && position != -1))
+            {
+                cout << "FAILURE: Check disagrees with classification" << endl;
+                exit(22);
+            }
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Benchmarks
+
+static double seconds_since(const chrono::steady_clock::time_point& start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Timestamp for per-call latency: Cycles where available, else nanoseconds
+static uint64_t read_timestamp()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_lfence();
+    return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+    uint32_t lo, hi;
+    __asm__ __volatile__("lfence\n\trdtsc" : "=a"(lo), "=d"(hi) :: "memory");
+    return ((uint64_t)hi << 32) | lo;
+#else
+    return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static void bench_interleave()
+{
+    static const int Depth = 64;
+    static const int FrameBytes = CRC16_ECC240_MAX_CODEWORD_BYTES;
+    static const int Iterations = 100000;
+
+    uint8_t frames[Depth * FrameBytes], wire[Depth * FrameBytes];
+    for (int i = 0; i < Depth * FrameBytes; ++i)
+    {
+        frames[i] = (uint8_t)(i * 7);
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < Iterations; ++i)
+    {
+        crc16_ecc240_interleave(frames, FrameBytes, Depth, wire);
+        frames[i % sizeof(frames)] ^= wire[(i * 13) % sizeof(wire)];
+    }
+    double interleaveSeconds = seconds_since(start);
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < Iterations; ++i)
+    {
+        crc16_ecc240_deinterleave(wire, FrameBytes, Depth, frames);
+        wire[i % sizeof(wire)] ^= frames[(i * 13) % sizeof(frames)];
+    }
+    double deinterleaveSeconds = seconds_since(start);
+
+    const double mb = (double)Iterations * sizeof(frames) / 1000000.;
+    cout << "Interleave depth " << Depth << ": " << mb / interleaveSeconds << " MB/s, deinterleave: "
+         << mb / deinterleaveSeconds << " MB/s" << endl;
+}
+
+/*
+    Time crc16_ecc240_generate() on 30-byte frames for the table variant
+    compiled in.  Build with -DCRC16_ECC240_TABLE_VARIANT=n to compare.
+
+    The cold figure sweeps an L1-sized buffer between frames, as other work
+    on a busy gateway would, and subtracts the cost of the sweep itself, so
+    the difference from the warm figure is the price of table cache misses.
+*/
+static void bench_generate()
+{
+    static const char* const Names[4] = { "bitwise", "nibble", "byte", "slicing-by-8" };
+    static const int TableBytes[4] = { 0, 32, 1024, 4096 };
+    static const int FrameBytes = 30;
+    static const int Frames = 1024;
+    static const int Iterations = 2000;
+    static const int Samples = 20000;
+    static const int EvictBytes = 64 * 1024; // Twice a typical L1 data cache
+
+    uint8_t* frames = new uint8_t[Frames * FrameBytes];
+    uint8_t* evict = new uint8_t[EvictBytes];
+    for (int i = 0; i < Frames * FrameBytes; ++i)
+    {
+        frames[i] = (uint8_t)(i * 7);
+    }
+    memset(evict, 1, EvictBytes);
+
+    uint16_t sink = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < Iterations; ++i)
+    {
+        for (int j = 0; j < Frames; ++j)
+        {
+            sink ^= crc16_ecc240_generate(frames + j * FrameBytes, FrameBytes);
+        }
+    }
+    double warmSeconds = seconds_since(start);
+
+    // Time single calls, so an eviction sweep can run between them and not
+    // overlap the call.  The frame itself is read back in after the sweep,
+    // so only the table starts cold.  Overhead is an empty timed interval
+    vector<uint64_t> ticks[3];
+    for (int phase = 0; phase < 3; ++phase)
+    {
+        ticks[phase].resize(Samples);
+        for (int j = 0; j < Samples; ++j)
+        {
+            const uint8_t* frame = frames + (j % Frames) * FrameBytes;
+            if (phase == 2)
+            {
+                for (int k = 0; k < EvictBytes; k += CRC16_ECC240_CACHE_LINE_BYTES)
+                {
+                    evict[k] += (uint8_t)sink;
+                }
+            }
+            sink ^= frame[0] ^ frame[FrameBytes - 1];
+
+            const uint64_t t0 = read_timestamp();
+            if (phase != 0)
+            {
+                sink ^= crc16_ecc240_generate(frame, FrameBytes);
+            }
+            ticks[phase][j] = read_timestamp() - t0;
+        }
+        sort(ticks[phase].begin(), ticks[phase].end());
+    }
+    const uint64_t overhead = ticks[0][Samples / 2];
+    const uint64_t warmTicks = ticks[1][Samples / 2] - min(overhead, ticks[1][Samples / 2]);
+    const uint64_t coldTicks = ticks[2][Samples / 2] - min(overhead, ticks[2][Samples / 2]);
+
+    const int v = CRC16_ECC240_TABLE_VARIANT;
+    cout << "Generate " << Names[v] << " (" << TableBytes[v] << " table bytes): "
+         << warmSeconds * 1e9 / ((double)Iterations * Frames) << " ns/frame warm, call ticks p50 "
+         << warmTicks << " warm, ";
+    if (coldTicks >= warmTicks)
+    {
+        cout << coldTicks << " L1-cold";
+    }
+    else
+    {
+        cout << "L1-cold not measurable";
+    }
+    cout << " (" << (sink & 1) << ")" << endl;
+
+    delete[] frames;
+    delete[] evict;
+}
+
+// Plain reflected CRC-32 (IEEE 802.3), one byte at a time, for comparison
+static uint32_t bench_crc32(const uint8_t* data, int bytes)
+{
+    static uint32_t table[256];
+    if (table[1] == 0)
+    {
+        for (uint32_t b = 0; b < 256; ++b)
+        {
+            uint32_t r = b;
+            for (int i = 0; i < 8; ++i)
+            {
+                r = (r >> 1) ^ ((r & 1) ? 0xedb88320 : 0);
+            }
+            table[b] = r;
+        }
+    }
+
+    uint32_t r = 0xffffffff;
+    for (int i = 0; i < bytes; ++i)
+    {
+        r = (r >> 8) ^ table[(uint8_t)r ^ data[i]];
+    }
+    return ~r;
+}
+
+// Dual-polynomial mode against CRC-32 on the longest supported frames
+static void bench_dual()
+{
+    static const int Bytes = CRC16_ECC240_DUAL_MAX_DATA_BYTES;
+    static const int Iterations = 20000;
+
+    uint8_t data[Bytes], copy[Bytes];
+    for (int i = 0; i < Bytes; ++i)
+    {
+        data[i] = (uint8_t)(i * 7);
+    }
+
+    uint32_t sink = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < Iterations; ++i)
+    {
+        sink ^= crc16_ecc240_dual_generate(data, Bytes);
+        data[i % Bytes] ^= (uint8_t)sink;
+    }
+    double dualSeconds = seconds_since(start);
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < Iterations; ++i)
+    {
+        sink ^= bench_crc32(data, Bytes);
+        data[i % Bytes] ^= (uint8_t)sink;
+    }
+    double crc32Seconds = seconds_since(start);
+
+    // Correction outcomes for 1, 2 and 3 random bit errors
+    const uint32_t crc = crc16_ecc240_dual_generate(data, Bytes);
+    int corrected[4] = { 0 }, miscorrected[4] = { 0 }, rejected[4] = { 0 };
+    uint32_t seed = 1;
+    static const int Trials = 2000;
+
+    for (int errors = 1; errors <= 3; ++errors)
+    {
+        for (int t = 0; t < Trials; ++t)
+        {
+            memcpy(copy, data, Bytes);
+            for (int e = 0; e < errors; ++e)
+            {
+                seed = seed * 1103515245 + 12345;
+                int bit = (int)((seed >> 8) % (Bytes * 8));
+                copy[bit / 8] ^= (uint8_t)(0x80 >> (bit % 8));
+            }
+
+            if (0 != crc16_ecc240_dual_check(copy, Bytes, crc))
+            {
+                ++rejected[errors];
+            }
+            else if (0 == memcmp(copy, data, Bytes))
+            {
+                ++corrected[errors];
+            }
+            else
+            {
+                ++miscorrected[errors];
+            }
+        }
+    }
+
+    const double mb = (double)Iterations * Bytes / 1000000.;
+    cout << "Dual CRC16 on " << Bytes << " bytes: " << mb / dualSeconds << " MB/s, CRC-32: "
+         << mb / crc32Seconds << " MB/s (" << (sink & 1) << ")" << endl;
+    for (int errors = 1; errors <= 3; ++errors)
+    {
+        cout << "  " << errors << " bit errors: corrected=" << corrected[errors]
+             << " miscorrected=" << miscorrected[errors] << " rejected=" << rejected[errors]
+             << " (CRC-32 detects only)" << endl;
+    }
+}
+
+/*
+    Loopback packets/sec with one datagram per receive and check, against
+    batches of 64.  A sender thread pushes datagrams with sendmmsg().
+*/
+static void bench_udp()
+{
+    static const int N = CRC16_ECC240_MAX_CODEWORD_BYTES;
+    static const int Packets = 200000;
+    static const int SendBatch = 64;
+
+    uint8_t frames[SendBatch * N];
+    for (int i = 0; i < SendBatch * N; ++i)
+    {
+        frames[i] = (uint8_t)(i * 7);
+    }
+    crc16_ecc240_encode_many(frames, N, N, SendBatch);
+
+    static const int BatchSizes[2] = { 1, 64 };
+    for (int b = 0; b < 2; ++b)
+    {
+        crc16_ecc240_udp_t* receiver = crc16_ecc240_udp_open("127.0.0.1", 0, N, BatchSizes[b]);
+        crc16_ecc240_udp_t* sender = crc16_ecc240_udp_open("127.0.0.1", 0, N, 1);
+        if (!receiver || !sender ||
+            0 != crc16_ecc240_udp_connect(sender, "127.0.0.1", crc16_ecc240_udp_port(receiver)))
+        {
+            cout << "UDP: Loopback sockets unavailable" << endl;
+            crc16_ecc240_udp_close(receiver);
+            crc16_ecc240_udp_close(sender);
+            return;
+        }
+
+        thread sendThread([&]() {
+            for (int sent = 0; sent < Packets; sent += SendBatch)
+            {
+                crc16_ecc240_udp_send(sender, frames, N, SendBatch);
+            }
+        });
+
+        crc16_ecc240_udp_counts_t counts;
+        memset(&counts, 0, sizeof(counts));
+        uint64_t forwarded = 0;
+        int received = 0;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        while (received < Packets)
+        {
+            int result = crc16_ecc240_udp_receive(receiver, 100, udp_forward, &forwarded, &counts);
+            if (result <= 0)
+            {
+                break; // The rest were dropped by the kernel
+            }
+            received += result;
+        }
+        double seconds = seconds_since(start);
+        sendThread.join();
+
+        cout << "UDP receive batch " << BatchSizes[b] << ": " << received / seconds / 1000000.
+             << " M packets/s, forwarded " << forwarded << " of " << Packets << endl;
+
+        crc16_ecc240_udp_close(receiver);
+        crc16_ecc240_udp_close(sender);
+    }
+}
+
+static uint64_t bench_now_nsec()
+{
+    return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Decode stage output: Copy good frames into the delivery ring
+static void pipeline_forward(void* context, uint8_t* frames, int count, const uint64_t* failed)
+{
+    crc16_ecc240_ring_t* out = (crc16_ecc240_ring_t*)context;
+
+    for (int i = 0; i < count;)
+    {
+        size_t reserved;
+        uint8_t* slots = crc16_ecc240_ring_write_begin(out, count - i, &reserved);
+        if (reserved == 0)
+        {
+            this_thread::yield(); // Backpressure from the delivery stage
+            continue;
+        }
 
-int main()
+        size_t written = 0;
+        for (size_t j = 0; j < reserved; ++j, ++i)
+        {
+            if (((failed[i / 64] >> (i % 64)) & 1) == 0)
+            {
+                memcpy(slots + written++ * CRC16_ECC240_RING_SLOT_BYTES,
+                       frames + i * CRC16_ECC240_RING_SLOT_BYTES, CRC16_ECC240_RING_SLOT_BYTES);
+            }
+        }
+        crc16_ecc240_ring_write_commit(out, written);
+    }
+}
+
+/*
+    Receive -> decode -> deliver over two rings, one thread per stage.
+    Each frame carries its send time, and the delivery stage records the
+    end-to-end latency.
+*/
+static void bench_pipeline()
+{
+    static const int N = CRC16_ECC240_RING_SLOT_BYTES;
+    static const uint32_t Frames = 1000000;
+
+    crc16_ecc240_ring_t* received = crc16_ecc240_ring_create(4096);
+    crc16_ecc240_ring_t* decoded = crc16_ecc240_ring_create(4096);
+
+    vector<uint32_t> latencies;
+    latencies.reserve(Frames);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    thread receiveStage([&]() {
+        uint32_t sequence = 0;
+        while (sequence < Frames)
+        {
+            size_t reserved;
+            uint8_t* slots = crc16_ecc240_ring_write_begin(received, 64, &reserved);
+            if (reserved == 0)
+            {
+                this_thread::yield();
+                continue;
+            }
+            if (reserved > Frames - sequence)
+            {
+                reserved = Frames - sequence;
+            }
+            const uint64_t now = bench_now_nsec();
+            for (size_t i = 0; i < reserved; ++i, ++sequence)
+            {
+                uint8_t* frame = slots + i * N;
+                memset(frame, (uint8_t)sequence, N);
+                memcpy(frame, &now, 8);
+                crc16_ecc240_encode_codeword(frame, N);
+                if (sequence % 1000 == 0) frame[20] ^= 0x40;
+            }
+            crc16_ecc240_ring_write_commit(received, reserved);
+        }
+    });
+
+    atomic<bool> decodeDone(false);
+    crc16_ecc240_counts_t counts;
+    memset(&counts, 0, sizeof(counts));
+
+    thread decodeStage([&]() {
+        uint64_t processed = 0;
+        while (processed < Frames)
+        {
+            int n = crc16_ecc240_ring_check(received, N, 256, pipeline_forward, decoded, &counts);
+            if (n == 0)
+            {
+                this_thread::yield();
+            }
+            processed += n;
+        }
+        decodeDone = true;
+    });
+
+    for (;;)
+    {
+        size_t taken;
+        uint8_t* slots = crc16_ecc240_ring_read_begin(decoded, 256, &taken);
+        if (taken == 0)
+        {
+            if (decodeDone && latencies.size() >= counts.Clean + counts.Corrected)
+            {
+                break;
+            }
+            this_thread::yield();
+            continue;
+        }
+        const uint64_t now = bench_now_nsec();
+        for (size_t i = 0; i < taken; ++i)
+        {
+            uint64_t sent;
+            memcpy(&sent, slots + i * N, 8);
+            latencies.push_back((uint32_t)(now - sent < 0xffffffff ? now - sent : 0xffffffff));
+        }
+        crc16_ecc240_ring_read_commit(decoded, taken);
+    }
+
+    double seconds = seconds_since(start);
+    receiveStage.join();
+    decodeStage.join();
+
+    sort(latencies.begin(), latencies.end());
+    const size_t n = latencies.size();
+    cout << "Pipeline: " << n / seconds / 1000000. << " M frames/s, latency usec p50="
+         << latencies[n / 2] / 1000. << " p99=" << latencies[n * 99 / 100] / 1000.
+         << " p99.9=" << latencies[n * 999 / 1000] / 1000. << " max=" << latencies[n - 1] / 1000.
+         << " (corrected " << counts.Corrected << ")" << endl;
+
+    crc16_ecc240_ring_destroy(received);
+    crc16_ecc240_ring_destroy(decoded);
+}
+
+static void bench_channel()
+{
+    static const size_t Bytes = 64 << 20;
+    vector<uint8_t> buffer(Bytes, 0);
+
+    static const double Rates[3] = { 1e-6, 1e-4, 1e-2 };
+    cout << "BSC channel:";
+    for (int r = 0; r < 3; ++r)
+    {
+        crc16_ecc240_channel_t* bsc = crc16_ecc240_channel_bsc(Rates[r], 1);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        crc16_ecc240_channel_apply(bsc, &buffer[0], Bytes);
+        double seconds = seconds_since(start);
+        crc16_ecc240_channel_destroy(bsc);
+
+        cout << " " << Rates[r] << " BER: " << Bytes * 8 / seconds / 1000000000. << " Gbit/s" << (r < 2 ? "," : "");
+    }
+    cout << endl;
+
+    static const uint64_t Frames = 1000000;
+    crc16_ecc240_trace_counts_t counts;
+    memset(&counts, 0, sizeof(counts));
+    crc16_ecc240_channel_t* ge = crc16_ecc240_channel_gilbert(0.0001, 0.01, 0.00001, 0.1, 1);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    crc16_ecc240_channel_evaluate(ge, CRC16_ECC240_MAX_CODEWORD_BYTES, Frames, nullptr, nullptr, &counts);
+    double seconds = seconds_since(start);
+    crc16_ecc240_channel_destroy(ge);
+
+    cout << "Gilbert-Elliott evaluation: " << Frames / seconds / 1000000. << "M frames/s (clean "
+         << counts.Clean << ", corrected " << counts.Corrected << ", miscorrected " << counts.Miscorrected
+         << ", rejected " << counts.Rejected << ")" << endl;
+}
+
+static void bench_constant()
+{
+    static const int TotalBytes = CRC16_ECC240_MAX_CODEWORD_BYTES;
+    static const int Samples = 200000;
+    static const char* const Cases[3] = { "clean", "1-bit", "2-bit" };
+
+    uint8_t frame[TotalBytes], copy[TotalBytes];
+    for (int i = 0; i < TotalBytes; ++i)
+    {
+        frame[i] = (uint8_t)(i * 11);
+    }
+    crc16_ecc240_encode_codeword(frame, TotalBytes);
+
+    vector<uint64_t> ticks(Samples);
+    uint32_t seed = 1;
+    volatile int sink = 0;
+
+    for (int constant = 0; constant < 2; ++constant)
+    {
+        cout << (constant ? "Constant-latency" : "Variable-latency") << " codeword check ticks p50/p99/max:";
+        uint64_t lowest = ~(uint64_t)0, highest = 0;
+
+        for (int c = 0; c < 3; ++c)
+        {
+            for (int i = 0; i < Samples; ++i)
+            {
+                memcpy(copy, frame, TotalBytes);
+                for (int e = 0; e < c; ++e)
+                {
+                    seed = seed * 1103515245 + 12345;
+                    const int bit = (int)((seed >> 8) % (TotalBytes * 8));
+                    copy[bit / 8] ^= (uint8_t)(0x80 >> (bit % 8));
+                }
+
+                const uint64_t t0 = read_timestamp();
+                sink = sink + (constant ? crc16_ecc240_check_codeword_constant(copy, TotalBytes)
+                                        : crc16_ecc240_check_codeword(copy, TotalBytes));
+                ticks[i] = read_timestamp() - t0;
+            }
+
+            sort(ticks.begin(), ticks.end());
+            cout << " " << Cases[c] << " " << ticks[Samples / 2] << "/" << ticks[Samples * 99 / 100] << "/"
+                 << ticks[Samples - 1] << (c < 2 ? "," : "");
+            lowest = min(lowest, ticks[Samples / 2]);
+            highest = max(highest, ticks[Samples * 99 / 100]);
+        }
+
+        cout << " (p99 / best p50 = " << (double)highest / lowest << ")" << endl;
+    }
+}
+
+static int bench_main()
+{
+    bench_generate();
+    bench_dual();
+    bench_interleave();
+    bench_udp();
+    bench_pipeline();
+    bench_channel();
+    bench_constant();
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// Tools
+
+static void scrub_report(void* context, const crc16_ecc240_scrub_region_t* region)
+{
+    (void)context;
+
+    // Only list regions that needed attention
+    if (region->Counts.Corrected == 0 && region->Counts.Failed == 0)
+    {
+        return;
+    }
+
+    cout << "  offset=" << region->Offset << " frames=" << region->Frames
+         << " corrected=" << region->Counts.Corrected << " failed=" << region->Counts.Failed << endl;
+}
+
+// crc scrub <file> [frameBytes] [regionBytes]
+static int scrub_main(int argc, char** argv)
+{
+    int totalBytes = CRC16_ECC240_MAX_CODEWORD_BYTES;
+    uint64_t regionBytes = 1 << 24;
+
+    if (argc >= 4) totalBytes = atoi(argv[3]);
+    if (argc >= 5) regionBytes = strtoull(argv[4], nullptr, 10);
+
+    if (argc < 3 || totalBytes < 4 || totalBytes > CRC16_ECC240_MAX_CODEWORD_BYTES || (totalBytes & 1))
+    {
+        cerr << "Usage: " << argv[0] << " scrub <file> [frameBytes] [regionBytes]" << endl;
+        return 1;
+    }
+
+    crc16_ecc240_counts_t total;
+    int result = crc16_ecc240_scrub_file(argv[2], totalBytes, regionBytes, scrub_report, nullptr, &total);
+    if (result != 0)
+    {
+        cerr << "FAILURE: Scrub of " << argv[2] << " failed with error " << result << endl;
+        return 2;
+    }
+
+    cout << "Scrubbed " << argv[2] << ": clean=" << total.Clean << " corrected=" << total.Corrected
+         << " failed=" << total.Failed << endl;
+    return total.Failed ? 3 : 0;
+}
+
+
+// Decoder configuration that only detects errors
+static int replay_detect_only(void* context, uint8_t* frame, int frameBytes)
+{
+    (void)context;
+    return crc16_ecc240_generate(frame, frameBytes) != 0 ? -1 : 0;
+}
+
+static int replay_main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        cerr << "Usage: " << argv[0] << " replay <trace>" << endl;
+        return 1;
+    }
+
+    static const struct
+    {
+        const char* Name;
+        crc16_ecc240_trace_decoder_t Decoder;
+    } Configs[2] = {
+        { "detect", replay_detect_only },
+        { "correct", nullptr },
+    };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        crc16_ecc240_trace_counts_t counts;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        int result = crc16_ecc240_trace_replay(argv[2], Configs[i].Decoder, nullptr, &counts);
+        double seconds = seconds_since(start);
+
+        if (result != 0)
+        {
+            cerr << "FAILURE: Replay of " << argv[2] << " failed with error " << result << endl;
+            return 2;
+        }
+
+        const uint64_t frames = counts.Clean + counts.Corrected + counts.Miscorrected + counts.Rejected;
+        cout << Configs[i].Name << ": clean=" << counts.Clean << " corrected=" << counts.Corrected
+             << " miscorrected=" << counts.Miscorrected << " rejected=" << counts.Rejected
+             << " (" << frames / seconds / 1000000. << " M frames/s)" << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
 {
+    if (argc >= 2 && 0 == strcmp(argv[1], "scrub"))
+    {
+        return scrub_main(argc, argv);
+    }
+    if (argc >= 2 && 0 == strcmp(argv[1], "replay"))
+    {
+        return replay_main(argc, argv);
+    }
+    if (argc >= 2 && 0 == strcmp(argv[1], "bench"))
+    {
+        return bench_main();
+    }
+
 #ifdef CRC16_ENABLE_TABLE_GENERATION_CODE
     crc16ecc240::GenerateAndPrint_CRC16_ECC240_REDUCTION_TABLE();
 #endif
@@ -92,6 +2317,45 @@ int main()
         }
     }
 
+#ifndef CRC16_ECC240_DISABLE_STATS
+    // Every bit position should have been corrected exactly once
+    crc16_ecc240_stats_t stats;
+    crc16_ecc240_stats_snapshot(&stats);
+    if (stats.Corrected != DataLength * 8 || stats.Uncorrectable != 0 || stats.Miscorrected != 0)
+    {
+        cout << "FAILURE: Unexpected statistics counts" << endl;
+        exit(3);
+    }
+    for (int j = 0; j < DataLength * 8; ++j)
+    {
+        if (stats.CorrectedBits[j] != 1)
+        {
+            cout << "FAILURE: Unexpected corrected bit histogram" << endl;
+            exit(3);
+        }
+    }
+#endif // CRC16_ECC240_DISABLE_STATS
+
+    test_codeword();
+    test_verify_many();
+    test_parallel();
+    test_iov();
+    test_stream();
+    test_interleave();
+    test_outer();
+    test_soft();
+    test_long();
+    test_dual();
+    test_trace();
+    test_udp();
+    test_ring();
+    test_pool();
+    test_channel();
+    test_constant();
+    test_policy();
+    test_batcher();
+    test_classify();
+
     cout << "Recovery success!" << endl;
     return 0;
 }
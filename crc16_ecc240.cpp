@@ -33,12 +33,169 @@
     using namespace std;
 #endif
 
+#ifndef CRC16_ECC240_DISABLE_STATS
+    #include <atomic>
+    #include <mutex>
+#endif
+
 namespace crc16ecc240 {
 
 
+//-----------------------------------------------------------------------------
+// Statistics
+
+#ifndef CRC16_ECC240_DISABLE_STATS
+
+/*
+    Per-thread counters.
+
+    Each thread gets its own block, padded on both sides so that no two threads
+    ever write to the same cache line.  Only the owning thread writes to its
+    block, so increments are a plain load and store without a locked RMW.
+    The atomics only exist so that snapshots from other threads are not torn.
+
+    Blocks are never freed, so counts from threads that have exited are still
+    included in snapshots.
+*/
+struct ThreadStats
+{
+    uint8_t PadBefore[CRC16_ECC240_CACHE_LINE_BYTES];
+
+    std::atomic<uint64_t> Clean;
+    std::atomic<uint64_t> Corrected;
+    std::atomic<uint64_t> Uncorrectable;
+    std::atomic<uint64_t> Miscorrected;
+    std::atomic<uint64_t> CorrectedBits[CRC16_ECC240_STATS_BIT_POSITIONS];
+
+    ThreadStats* Next;
+
+    uint8_t PadAfter[CRC16_ECC240_CACHE_LINE_BYTES];
+
+    void Reset()
+    {
+        Clean.store(0, std::memory_order_relaxed);
+        Corrected.store(0, std::memory_order_relaxed);
+        Uncorrectable.store(0, std::memory_order_relaxed);
+        Miscorrected.store(0, std::memory_order_relaxed);
+        for (int i = 0; i < CRC16_ECC240_STATS_BIT_POSITIONS; ++i)
+            CorrectedBits[i].store(0, std::memory_order_relaxed);
+    }
+};
+
+static std::mutex StatsListLock;
+static ThreadStats* StatsList = nullptr;
+static CRC16_ECC240_THREAD_LOCAL ThreadStats* LocalStats = nullptr;
+
+static ThreadStats* RegisterThreadStats()
+{
+    ThreadStats* stats = new ThreadStats;
+    stats->Reset();
+
+    std::lock_guard<std::mutex> locker(StatsListLock);
+    stats->Next = StatsList;
+    StatsList = stats;
+    LocalStats = stats;
+
+    return stats;
+}
+
+static CRC16_ECC240_FORCE_INLINE ThreadStats* GetThreadStats()
+{
+    ThreadStats* stats = LocalStats;
+    if (!stats)
+    {
+        stats = RegisterThreadStats();
+    }
+    return stats;
+}
+
+static CRC16_ECC240_FORCE_INLINE void StatsAdd(std::atomic<uint64_t>& counter, uint64_t count)
+{
+    // Single writer: No need for a locked increment
+    counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+}
+
+static CRC16_ECC240_FORCE_INLINE void RecordClean(uint64_t count = 1)
+{
+    StatsAdd(GetThreadStats()->Clean, count);
+}
+
+static void RecordCorrected(int bitPosition)
+{
+    ThreadStats* stats = GetThreadStats();
+    StatsAdd(stats->Corrected, 1);
+    if ((unsigned)bitPosition < CRC16_ECC240_STATS_BIT_POSITIONS)
+    {
+        StatsAdd(stats->CorrectedBits[bitPosition], 1);
+    }
+}
+
+static void RecordUncorrectable()
+{
+    StatsAdd(GetThreadStats()->Uncorrectable, 1);
+}
+
+static void RecordMiscorrected()
+{
+    StatsAdd(GetThreadStats()->Miscorrected, 1);
+}
+
+#else // CRC16_ECC240_DISABLE_STATS
+
+static CRC16_ECC240_FORCE_INLINE void RecordClean(uint64_t = 1) {}
+static CRC16_ECC240_FORCE_INLINE void RecordCorrected(int) {}
+static CRC16_ECC240_FORCE_INLINE void RecordUncorrectable() {}
+static CRC16_ECC240_FORCE_INLINE void RecordMiscorrected() {}
+
+#endif // CRC16_ECC240_DISABLE_STATS
+
+extern "C" void crc16_ecc240_stats_snapshot(crc16_ecc240_stats_t* stats)
+{
+    memset(stats, 0, sizeof(crc16_ecc240_stats_t));
+
+#ifndef CRC16_ECC240_DISABLE_STATS
+    std::lock_guard<std::mutex> locker(StatsListLock);
+
+    for (ThreadStats* ts = StatsList; ts; ts = ts->Next)
+    {
+        stats->Clean += ts->Clean.load(std::memory_order_relaxed);
+        stats->Corrected += ts->Corrected.load(std::memory_order_relaxed);
+        stats->Uncorrectable += ts->Uncorrectable.load(std::memory_order_relaxed);
+        stats->Miscorrected += ts->Miscorrected.load(std::memory_order_relaxed);
+        for (int i = 0; i < CRC16_ECC240_STATS_BIT_POSITIONS; ++i)
+            stats->CorrectedBits[i] += ts->CorrectedBits[i].load(std::memory_order_relaxed);
+    }
+#endif
+}
+
+extern "C" void crc16_ecc240_stats_merge(crc16_ecc240_stats_t* to, const crc16_ecc240_stats_t* from)
+{
+    to->Clean += from->Clean;
+    to->Corrected += from->Corrected;
+    to->Uncorrectable += from->Uncorrectable;
+    to->Miscorrected += from->Miscorrected;
+    for (int i = 0; i < CRC16_ECC240_STATS_BIT_POSITIONS; ++i)
+        to->CorrectedBits[i] += from->CorrectedBits[i];
+}
+
+extern "C" void crc16_ecc240_stats_reset()
+{
+#ifndef CRC16_ECC240_DISABLE_STATS
+    std::lock_guard<std::mutex> locker(StatsListLock);
+
+    for (ThreadStats* ts = StatsList; ts; ts = ts->Next)
+    {
+        ts->Reset();
+    }
+#endif
+}
+
+
 //-----------------------------------------------------------------------------
 // crc16_ecc240_generate
 
+#if CRC16_ECC240_TABLE_VARIANT >= CRC16_ECC240_TABLE_BYTE
+
 /*
     CRC reduction table.
 
@@ -85,17 +242,176 @@ const uint16_t CRC16_ECC240_REDUCE[2][256] = {
     }
 };
 
+#endif // CRC16_ECC240_TABLE_BYTE
+
+#if CRC16_ECC240_TABLE_VARIANT == CRC16_ECC240_TABLE_SLICING8
+
+/*
+    Slicing-by-8 tables, continuing CRC16_ECC240_REDUCE to the left.
+
+    Table[k] is reduction for xx << (32 + 8 * k)
+*/
+const uint16_t CRC16_ECC240_SLICE[6][256] = {
+    {
+        0, 0xf081, 0xb837, 0x48b6, 0x295b, 0xd9da, 0x916c, 0x61ed, 0x52b6, 0xa237, 0xea81, 0x1a00, 0x7bed, 0x8b6c, 0xc3da, 0x335b,
+        0xa56c, 0x55ed, 0x1d5b, 0xedda, 0x8c37, 0x7cb6, 0x3400, 0xc481, 0xf7da, 0x75b, 0x4fed, 0xbf6c, 0xde81, 0x2e00, 0x66b6, 0x9637,
+        0x13ed, 0xe36c, 0xabda, 0x5b5b, 0x3ab6, 0xca37, 0x8281, 0x7200, 0x415b, 0xb1da, 0xf96c, 0x9ed, 0x6800, 0x9881, 0xd037, 0x20b6,
+        0xb681, 0x4600, 0xeb6, 0xfe37, 0x9fda, 0x6f5b, 0x27ed, 0xd76c, 0xe437, 0x14b6, 0x5c00, 0xac81, 0xcd6c, 0x3ded, 0x755b, 0x85da,
+        0x27da, 0xd75b, 0x9fed, 0x6f6c, 0xe81, 0xfe00, 0xb6b6, 0x4637, 0x756c, 0x85ed, 0xcd5b, 0x3dda, 0x5c37, 0xacb6, 0xe400, 0x1481,
+        0x82b6, 0x7237, 0x3a81, 0xca00, 0xabed, 0x5b6c, 0x13da, 0xe35b, 0xd000, 0x2081, 0x6837, 0x98b6, 0xf95b, 0x9da, 0x416c, 0xb1ed,
+        0x3437, 0xc4b6, 0x8c00, 0x7c81, 0x1d6c, 0xeded, 0xa55b, 0x55da, 0x6681, 0x9600, 0xdeb6, 0x2e37, 0x4fda, 0xbf5b, 0xf7ed, 0x76c,
+        0x915b, 0x61da, 0x296c, 0xd9ed, 0xb800, 0x4881, 0x37, 0xf0b6, 0xc3ed, 0x336c, 0x7bda, 0x8b5b, 0xeab6, 0x1a37, 0x5281, 0xa200,
+        0x4fb4, 0xbf35, 0xf783, 0x702, 0x66ef, 0x966e, 0xded8, 0x2e59, 0x1d02, 0xed83, 0xa535, 0x55b4, 0x3459, 0xc4d8, 0x8c6e, 0x7cef,
+        0xead8, 0x1a59, 0x52ef, 0xa26e, 0xc383, 0x3302, 0x7bb4, 0x8b35, 0xb86e, 0x48ef, 0x59, 0xf0d8, 0x9135, 0x61b4, 0x2902, 0xd983,
+        0x5c59, 0xacd8, 0xe46e, 0x14ef, 0x7502, 0x8583, 0xcd35, 0x3db4, 0xeef, 0xfe6e, 0xb6d8, 0x4659, 0x27b4, 0xd735, 0x9f83, 0x6f02,
+        0xf935, 0x9b4, 0x4102, 0xb183, 0xd06e, 0x20ef, 0x6859, 0x98d8, 0xab83, 0x5b02, 0x13b4, 0xe335, 0x82d8, 0x7259, 0x3aef, 0xca6e,
+        0x686e, 0x98ef, 0xd059, 0x20d8, 0x4135, 0xb1b4, 0xf902, 0x983, 0x3ad8, 0xca59, 0x82ef, 0x726e, 0x1383, 0xe302, 0xabb4, 0x5b35,
+        0xcd02, 0x3d83, 0x7535, 0x85b4, 0xe459, 0x14d8, 0x5c6e, 0xacef, 0x9fb4, 0x6f35, 0x2783, 0xd702, 0xb6ef, 0x466e, 0xed8, 0xfe59,
+        0x7b83, 0x8b02, 0xc3b4, 0x3335, 0x52d8, 0xa259, 0xeaef, 0x1a6e, 0x2935, 0xd9b4, 0x9102, 0x6183, 0x6e, 0xf0ef, 0xb859, 0x48d8,
+        0xdeef, 0x2e6e, 0x66d8, 0x9659, 0xf7b4, 0x735, 0x4f83, 0xbf02, 0x8c59, 0x7cd8, 0x346e, 0xc4ef, 0xa502, 0x5583, 0x1d35, 0xedb4,
+    }, {
+        0, 0x9f68, 0x67e5, 0xf88d, 0xcfca, 0x50a2, 0xa82f, 0x3747, 0xc6a1, 0x59c9, 0xa144, 0x3e2c, 0x96b, 0x9603, 0x6e8e, 0xf1e6,
+        0xd477, 0x4b1f, 0xb392, 0x2cfa, 0x1bbd, 0x84d5, 0x7c58, 0xe330, 0x12d6, 0x8dbe, 0x7533, 0xea5b, 0xdd1c, 0x4274, 0xbaf9, 0x2591,
+        0xf1db, 0x6eb3, 0x963e, 0x956, 0x3e11, 0xa179, 0x59f4, 0xc69c, 0x377a, 0xa812, 0x509f, 0xcff7, 0xf8b0, 0x67d8, 0x9f55, 0x3d,
+        0x25ac, 0xbac4, 0x4249, 0xdd21, 0xea66, 0x750e, 0x8d83, 0x12eb, 0xe30d, 0x7c65, 0x84e8, 0x1b80, 0x2cc7, 0xb3af, 0x4b22, 0xd44a,
+        0xba83, 0x25eb, 0xdd66, 0x420e, 0x7549, 0xea21, 0x12ac, 0x8dc4, 0x7c22, 0xe34a, 0x1bc7, 0x84af, 0xb3e8, 0x2c80, 0xd40d, 0x4b65,
+        0x6ef4, 0xf19c, 0x911, 0x9679, 0xa13e, 0x3e56, 0xc6db, 0x59b3, 0xa855, 0x373d, 0xcfb0, 0x50d8, 0x679f, 0xf8f7, 0x7a, 0x9f12,
+        0x4b58, 0xd430, 0x2cbd, 0xb3d5, 0x8492, 0x1bfa, 0xe377, 0x7c1f, 0x8df9, 0x1291, 0xea1c, 0x7574, 0x4233, 0xdd5b, 0x25d6, 0xbabe,
+        0x9f2f, 0x47, 0xf8ca, 0x67a2, 0x50e5, 0xcf8d, 0x3700, 0xa868, 0x598e, 0xc6e6, 0x3e6b, 0xa103, 0x9644, 0x92c, 0xf1a1, 0x6ec9,
+        0x2c33, 0xb35b, 0x4bd6, 0xd4be, 0xe3f9, 0x7c91, 0x841c, 0x1b74, 0xea92, 0x75fa, 0x8d77, 0x121f, 0x2558, 0xba30, 0x42bd, 0xddd5,
+        0xf844, 0x672c, 0x9fa1, 0xc9, 0x378e, 0xa8e6, 0x506b, 0xcf03, 0x3ee5, 0xa18d, 0x5900, 0xc668, 0xf12f, 0x6e47, 0x96ca, 0x9a2,
+        0xdde8, 0x4280, 0xba0d, 0x2565, 0x1222, 0x8d4a, 0x75c7, 0xeaaf, 0x1b49, 0x8421, 0x7cac, 0xe3c4, 0xd483, 0x4beb, 0xb366, 0x2c0e,
+        0x99f, 0x96f7, 0x6e7a, 0xf112, 0xc655, 0x593d, 0xa1b0, 0x3ed8, 0xcf3e, 0x5056, 0xa8db, 0x37b3, 0xf4, 0x9f9c, 0x6711, 0xf879,
+        0x96b0, 0x9d8, 0xf155, 0x6e3d, 0x597a, 0xc612, 0x3e9f, 0xa1f7, 0x5011, 0xcf79, 0x37f4, 0xa89c, 0x9fdb, 0xb3, 0xf83e, 0x6756,
+        0x42c7, 0xddaf, 0x2522, 0xba4a, 0x8d0d, 0x1265, 0xeae8, 0x7580, 0x8466, 0x1b0e, 0xe383, 0x7ceb, 0x4bac, 0xd4c4, 0x2c49, 0xb321,
+        0x676b, 0xf803, 0x8e, 0x9fe6, 0xa8a1, 0x37c9, 0xcf44, 0x502c, 0xa1ca, 0x3ea2, 0xc62f, 0x5947, 0x6e00, 0xf168, 0x9e5, 0x968d,
+        0xb31c, 0x2c74, 0xd4f9, 0x4b91, 0x7cd6, 0xe3be, 0x1b33, 0x845b, 0x75bd, 0xead5, 0x1258, 0x8d30, 0xba77, 0x251f, 0xdd92, 0x42fa,
+    }, {
+        0, 0x5866, 0xb0cc, 0xe8aa, 0x38ad, 0x60cb, 0x8861, 0xd007, 0x715a, 0x293c, 0xc196, 0x99f0, 0x49f7, 0x1191, 0xf93b, 0xa15d,
+        0xe2b4, 0xbad2, 0x5278, 0xa1e, 0xda19, 0x827f, 0x6ad5, 0x32b3, 0x93ee, 0xcb88, 0x2322, 0x7b44, 0xab43, 0xf325, 0x1b8f, 0x43e9,
+        0x9c5d, 0xc43b, 0x2c91, 0x74f7, 0xa4f0, 0xfc96, 0x143c, 0x4c5a, 0xed07, 0xb561, 0x5dcb, 0x5ad, 0xd5aa, 0x8dcc, 0x6566, 0x3d00,
+        0x7ee9, 0x268f, 0xce25, 0x9643, 0x4644, 0x1e22, 0xf688, 0xaeee, 0xfb3, 0x57d5, 0xbf7f, 0xe719, 0x371e, 0x6f78, 0x87d2, 0xdfb4,
+        0x618f, 0x39e9, 0xd143, 0x8925, 0x5922, 0x144, 0xe9ee, 0xb188, 0x10d5, 0x48b3, 0xa019, 0xf87f, 0x2878, 0x701e, 0x98b4, 0xc0d2,
+        0x833b, 0xdb5d, 0x33f7, 0x6b91, 0xbb96, 0xe3f0, 0xb5a, 0x533c, 0xf261, 0xaa07, 0x42ad, 0x1acb, 0xcacc, 0x92aa, 0x7a00, 0x2266,
+        0xfdd2, 0xa5b4, 0x4d1e, 0x1578, 0xc57f, 0x9d19, 0x75b3, 0x2dd5, 0x8c88, 0xd4ee, 0x3c44, 0x6422, 0xb425, 0xec43, 0x4e9, 0x5c8f,
+        0x1f66, 0x4700, 0xafaa, 0xf7cc, 0x27cb, 0x7fad, 0x9707, 0xcf61, 0x6e3c, 0x365a, 0xdef0, 0x8696, 0x5691, 0xef7, 0xe65d, 0xbe3b,
+        0xc31e, 0x9b78, 0x73d2, 0x2bb4, 0xfbb3, 0xa3d5, 0x4b7f, 0x1319, 0xb244, 0xea22, 0x288, 0x5aee, 0x8ae9, 0xd28f, 0x3a25, 0x6243,
+        0x21aa, 0x79cc, 0x9166, 0xc900, 0x1907, 0x4161, 0xa9cb, 0xf1ad, 0x50f0, 0x896, 0xe03c, 0xb85a, 0x685d, 0x303b, 0xd891, 0x80f7,
+        0x5f43, 0x725, 0xef8f, 0xb7e9, 0x67ee, 0x3f88, 0xd722, 0x8f44, 0x2e19, 0x767f, 0x9ed5, 0xc6b3, 0x16b4, 0x4ed2, 0xa678, 0xfe1e,
+        0xbdf7, 0xe591, 0xd3b, 0x555d, 0x855a, 0xdd3c, 0x3596, 0x6df0, 0xccad, 0x94cb, 0x7c61, 0x2407, 0xf400, 0xac66, 0x44cc, 0x1caa,
+        0xa291, 0xfaf7, 0x125d, 0x4a3b, 0x9a3c, 0xc25a, 0x2af0, 0x7296, 0xd3cb, 0x8bad, 0x6307, 0x3b61, 0xeb66, 0xb300, 0x5baa, 0x3cc,
+        0x4025, 0x1843, 0xf0e9, 0xa88f, 0x7888, 0x20ee, 0xc844, 0x9022, 0x317f, 0x6919, 0x81b3, 0xd9d5, 0x9d2, 0x51b4, 0xb91e, 0xe178,
+        0x3ecc, 0x66aa, 0x8e00, 0xd666, 0x661, 0x5e07, 0xb6ad, 0xeecb, 0x4f96, 0x17f0, 0xff5a, 0xa73c, 0x773b, 0x2f5d, 0xc7f7, 0x9f91,
+        0xdc78, 0x841e, 0x6cb4, 0x34d2, 0xe4d5, 0xbcb3, 0x5419, 0xc7f, 0xad22, 0xf544, 0x1dee, 0x4588, 0x958f, 0xcde9, 0x2543, 0x7d25,
+    }, {
+        0, 0xdf09, 0xe727, 0x382e, 0x977b, 0x4872, 0x705c, 0xaf55, 0x77c3, 0xa8ca, 0x90e4, 0x4fed, 0xe0b8, 0x3fb1, 0x79f, 0xd896,
+        0xef86, 0x308f, 0x8a1, 0xd7a8, 0x78fd, 0xa7f4, 0x9fda, 0x40d3, 0x9845, 0x474c, 0x7f62, 0xa06b, 0xf3e, 0xd037, 0xe819, 0x3710,
+        0x8639, 0x5930, 0x611e, 0xbe17, 0x1142, 0xce4b, 0xf665, 0x296c, 0xf1fa, 0x2ef3, 0x16dd, 0xc9d4, 0x6681, 0xb988, 0x81a6, 0x5eaf,
+        0x69bf, 0xb6b6, 0x8e98, 0x5191, 0xfec4, 0x21cd, 0x19e3, 0xc6ea, 0x1e7c, 0xc175, 0xf95b, 0x2652, 0x8907, 0x560e, 0x6e20, 0xb129,
+        0x5547, 0x8a4e, 0xb260, 0x6d69, 0xc23c, 0x1d35, 0x251b, 0xfa12, 0x2284, 0xfd8d, 0xc5a3, 0x1aaa, 0xb5ff, 0x6af6, 0x52d8, 0x8dd1,
+        0xbac1, 0x65c8, 0x5de6, 0x82ef, 0x2dba, 0xf2b3, 0xca9d, 0x1594, 0xcd02, 0x120b, 0x2a25, 0xf52c, 0x5a79, 0x8570, 0xbd5e, 0x6257,
+        0xd37e, 0xc77, 0x3459, 0xeb50, 0x4405, 0x9b0c, 0xa322, 0x7c2b, 0xa4bd, 0x7bb4, 0x439a, 0x9c93, 0x33c6, 0xeccf, 0xd4e1, 0xbe8,
+        0x3cf8, 0xe3f1, 0xdbdf, 0x4d6, 0xab83, 0x748a, 0x4ca4, 0x93ad, 0x4b3b, 0x9432, 0xac1c, 0x7315, 0xdc40, 0x349, 0x3b67, 0xe46e,
+        0xaa8e, 0x7587, 0x4da9, 0x92a0, 0x3df5, 0xe2fc, 0xdad2, 0x5db, 0xdd4d, 0x244, 0x3a6a, 0xe563, 0x4a36, 0x953f, 0xad11, 0x7218,
+        0x4508, 0x9a01, 0xa22f, 0x7d26, 0xd273, 0xd7a, 0x3554, 0xea5d, 0x32cb, 0xedc2, 0xd5ec, 0xae5, 0xa5b0, 0x7ab9, 0x4297, 0x9d9e,
+        0x2cb7, 0xf3be, 0xcb90, 0x1499, 0xbbcc, 0x64c5, 0x5ceb, 0x83e2, 0x5b74, 0x847d, 0xbc53, 0x635a, 0xcc0f, 0x1306, 0x2b28, 0xf421,
+        0xc331, 0x1c38, 0x2416, 0xfb1f, 0x544a, 0x8b43, 0xb36d, 0x6c64, 0xb4f2, 0x6bfb, 0x53d5, 0x8cdc, 0x2389, 0xfc80, 0xc4ae, 0x1ba7,
+        0xffc9, 0x20c0, 0x18ee, 0xc7e7, 0x68b2, 0xb7bb, 0x8f95, 0x509c, 0x880a, 0x5703, 0x6f2d, 0xb024, 0x1f71, 0xc078, 0xf856, 0x275f,
+        0x104f, 0xcf46, 0xf768, 0x2861, 0x8734, 0x583d, 0x6013, 0xbf1a, 0x678c, 0xb885, 0x80ab, 0x5fa2, 0xf0f7, 0x2ffe, 0x17d0, 0xc8d9,
+        0x79f0, 0xa6f9, 0x9ed7, 0x41de, 0xee8b, 0x3182, 0x9ac, 0xd6a5, 0xe33, 0xd13a, 0xe914, 0x361d, 0x9948, 0x4641, 0x7e6f, 0xa166,
+        0x9676, 0x497f, 0x7151, 0xae58, 0x10d, 0xde04, 0xe62a, 0x3923, 0xe1b5, 0x3ebc, 0x692, 0xd99b, 0x76ce, 0xa9c7, 0x91e9, 0x4ee0,
+    }, {
+        0, 0xc29, 0x1852, 0x147b, 0x30a4, 0x3c8d, 0x28f6, 0x24df, 0x6148, 0x6d61, 0x791a, 0x7533, 0x51ec, 0x5dc5, 0x49be, 0x4597,
+        0xc290, 0xceb9, 0xdac2, 0xd6eb, 0xf234, 0xfe1d, 0xea66, 0xe64f, 0xa3d8, 0xaff1, 0xbb8a, 0xb7a3, 0x937c, 0x9f55, 0x8b2e, 0x8707,
+        0xdc15, 0xd03c, 0xc447, 0xc86e, 0xecb1, 0xe098, 0xf4e3, 0xf8ca, 0xbd5d, 0xb174, 0xa50f, 0xa926, 0x8df9, 0x81d0, 0x95ab, 0x9982,
+        0x1e85, 0x12ac, 0x6d7, 0xafe, 0x2e21, 0x2208, 0x3673, 0x3a5a, 0x7fcd, 0x73e4, 0x679f, 0x6bb6, 0x4f69, 0x4340, 0x573b, 0x5b12,
+        0xe11f, 0xed36, 0xf94d, 0xf564, 0xd1bb, 0xdd92, 0xc9e9, 0xc5c0, 0x8057, 0x8c7e, 0x9805, 0x942c, 0xb0f3, 0xbcda, 0xa8a1, 0xa488,
+        0x238f, 0x2fa6, 0x3bdd, 0x37f4, 0x132b, 0x1f02, 0xb79, 0x750, 0x42c7, 0x4eee, 0x5a95, 0x56bc, 0x7263, 0x7e4a, 0x6a31, 0x6618,
+        0x3d0a, 0x3123, 0x2558, 0x2971, 0xdae, 0x187, 0x15fc, 0x19d5, 0x5c42, 0x506b, 0x4410, 0x4839, 0x6ce6, 0x60cf, 0x74b4, 0x789d,
+        0xff9a, 0xf3b3, 0xe7c8, 0xebe1, 0xcf3e, 0xc317, 0xd76c, 0xdb45, 0x9ed2, 0x92fb, 0x8680, 0x8aa9, 0xae76, 0xa25f, 0xb624, 0xba0d,
+        0x9b0b, 0x9722, 0x8359, 0x8f70, 0xabaf, 0xa786, 0xb3fd, 0xbfd4, 0xfa43, 0xf66a, 0xe211, 0xee38, 0xcae7, 0xc6ce, 0xd2b5, 0xde9c,
+        0x599b, 0x55b2, 0x41c9, 0x4de0, 0x693f, 0x6516, 0x716d, 0x7d44, 0x38d3, 0x34fa, 0x2081, 0x2ca8, 0x877, 0x45e, 0x1025, 0x1c0c,
+        0x471e, 0x4b37, 0x5f4c, 0x5365, 0x77ba, 0x7b93, 0x6fe8, 0x63c1, 0x2656, 0x2a7f, 0x3e04, 0x322d, 0x16f2, 0x1adb, 0xea0, 0x289,
+        0x858e, 0x89a7, 0x9ddc, 0x91f5, 0xb52a, 0xb903, 0xad78, 0xa151, 0xe4c6, 0xe8ef, 0xfc94, 0xf0bd, 0xd462, 0xd84b, 0xcc30, 0xc019,
+        0x7a14, 0x763d, 0x6246, 0x6e6f, 0x4ab0, 0x4699, 0x52e2, 0x5ecb, 0x1b5c, 0x1775, 0x30e, 0xf27, 0x2bf8, 0x27d1, 0x33aa, 0x3f83,
+        0xb884, 0xb4ad, 0xa0d6, 0xacff, 0x8820, 0x8409, 0x9072, 0x9c5b, 0xd9cc, 0xd5e5, 0xc19e, 0xcdb7, 0xe968, 0xe541, 0xf13a, 0xfd13,
+        0xa601, 0xaa28, 0xbe53, 0xb27a, 0x96a5, 0x9a8c, 0x8ef7, 0x82de, 0xc749, 0xcb60, 0xdf1b, 0xd332, 0xf7ed, 0xfbc4, 0xefbf, 0xe396,
+        0x6491, 0x68b8, 0x7cc3, 0x70ea, 0x5435, 0x581c, 0x4c67, 0x404e, 0x5d9, 0x9f0, 0x1d8b, 0x11a2, 0x357d, 0x3954, 0x2d2f, 0x2106,
+    }, {
+        0, 0x6f23, 0xde46, 0xb165, 0xe5b9, 0x8a9a, 0x3bff, 0x54dc, 0x9247, 0xfd64, 0x4c01, 0x2322, 0x77fe, 0x18dd, 0xa9b8, 0xc69b,
+        0x7dbb, 0x1298, 0xa3fd, 0xccde, 0x9802, 0xf721, 0x4644, 0x2967, 0xeffc, 0x80df, 0x31ba, 0x5e99, 0xa45, 0x6566, 0xd403, 0xbb20,
+        0xfb76, 0x9455, 0x2530, 0x4a13, 0x1ecf, 0x71ec, 0xc089, 0xafaa, 0x6931, 0x612, 0xb777, 0xd854, 0x8c88, 0xe3ab, 0x52ce, 0x3ded,
+        0x86cd, 0xe9ee, 0x588b, 0x37a8, 0x6374, 0xc57, 0xbd32, 0xd211, 0x148a, 0x7ba9, 0xcacc, 0xa5ef, 0xf133, 0x9e10, 0x2f75, 0x4056,
+        0xafd9, 0xc0fa, 0x719f, 0x1ebc, 0x4a60, 0x2543, 0x9426, 0xfb05, 0x3d9e, 0x52bd, 0xe3d8, 0x8cfb, 0xd827, 0xb704, 0x661, 0x6942,
+        0xd262, 0xbd41, 0xc24, 0x6307, 0x37db, 0x58f8, 0xe99d, 0x86be, 0x4025, 0x2f06, 0x9e63, 0xf140, 0xa59c, 0xcabf, 0x7bda, 0x14f9,
+        0x54af, 0x3b8c, 0x8ae9, 0xe5ca, 0xb116, 0xde35, 0x6f50, 0x73, 0xc6e8, 0xa9cb, 0x18ae, 0x778d, 0x2351, 0x4c72, 0xfd17, 0x9234,
+        0x2914, 0x4637, 0xf752, 0x9871, 0xccad, 0xa38e, 0x12eb, 0x7dc8, 0xbb53, 0xd470, 0x6515, 0xa36, 0x5eea, 0x31c9, 0x80ac, 0xef8f,
+        0x687, 0x69a4, 0xd8c1, 0xb7e2, 0xe33e, 0x8c1d, 0x3d78, 0x525b, 0x94c0, 0xfbe3, 0x4a86, 0x25a5, 0x7179, 0x1e5a, 0xaf3f, 0xc01c,
+        0x7b3c, 0x141f, 0xa57a, 0xca59, 0x9e85, 0xf1a6, 0x40c3, 0x2fe0, 0xe97b, 0x8658, 0x373d, 0x581e, 0xcc2, 0x63e1, 0xd284, 0xbda7,
+        0xfdf1, 0x92d2, 0x23b7, 0x4c94, 0x1848, 0x776b, 0xc60e, 0xa92d, 0x6fb6, 0x95, 0xb1f0, 0xded3, 0x8a0f, 0xe52c, 0x5449, 0x3b6a,
+        0x804a, 0xef69, 0x5e0c, 0x312f, 0x65f3, 0xad0, 0xbbb5, 0xd496, 0x120d, 0x7d2e, 0xcc4b, 0xa368, 0xf7b4, 0x9897, 0x29f2, 0x46d1,
+        0xa95e, 0xc67d, 0x7718, 0x183b, 0x4ce7, 0x23c4, 0x92a1, 0xfd82, 0x3b19, 0x543a, 0xe55f, 0x8a7c, 0xdea0, 0xb183, 0xe6, 0x6fc5,
+        0xd4e5, 0xbbc6, 0xaa3, 0x6580, 0x315c, 0x5e7f, 0xef1a, 0x8039, 0x46a2, 0x2981, 0x98e4, 0xf7c7, 0xa31b, 0xcc38, 0x7d5d, 0x127e,
+        0x5228, 0x3d0b, 0x8c6e, 0xe34d, 0xb791, 0xd8b2, 0x69d7, 0x6f4, 0xc06f, 0xaf4c, 0x1e29, 0x710a, 0x25d6, 0x4af5, 0xfb90, 0x94b3,
+        0x2f93, 0x40b0, 0xf1d5, 0x9ef6, 0xca2a, 0xa509, 0x146c, 0x7b4f, 0xbdd4, 0xd2f7, 0x6392, 0xcb1, 0x586d, 0x374e, 0x862b, 0xe908,
+    }
+};
+
+#endif // CRC16_ECC240_TABLE_SLICING8
+
+#if CRC16_ECC240_TABLE_VARIANT == CRC16_ECC240_TABLE_NIBBLE
+
+// Reduction for x << 16, one entry per nibble
+static const uint16_t CRC16_ECC240_REDUCE_NIBBLE[16] = {
+    0, 0x5935, 0xb26a, 0xeb5f, 0x3de1, 0x64d4, 0x8f8b, 0xd6be, 0x7bc2, 0x22f7, 0xc9a8, 0x909d, 0x4623, 0x1f16, 0xf449, 0xad7c,
+};
+
+#endif // CRC16_ECC240_TABLE_NIBBLE
+
+// r * x^16 mod CRC16_ECC240_POLY
 static CRC16_ECC240_FORCE_INLINE uint16_t crc16_reduce(uint16_t r)
 {
+#if CRC16_ECC240_TABLE_VARIANT == CRC16_ECC240_TABLE_BITWISE
+    for (int i = 0; i < 16; ++i)
+    {
+        r = (uint16_t)((r << 1) ^ ((r & 0x8000) ? (CRC16_ECC240_POLY & 0xffff) : 0));
+    }
+    return r;
+#elif CRC16_ECC240_TABLE_VARIANT == CRC16_ECC240_TABLE_NIBBLE
+    for (int i = 0; i < 4; ++i)
+    {
+        r = (uint16_t)(r << 4) ^ CRC16_ECC240_REDUCE_NIBBLE[r >> 12];
+    }
+    return r;
+#else
     return CRC16_ECC240_REDUCE[0][r & 0xff] ^ CRC16_ECC240_REDUCE[1][r >> 8];
+#endif
 }
 
 extern "C" uint16_t crc16_ecc240_generate(const void* vdata, int bytes)
 {
     const uint8_t * CRC16_ECC240_RESTRICT data = reinterpret_cast<const uint8_t * CRC16_ECC240_RESTRICT>(vdata);
     uint16_t r = 0;
+    int i = 0;
 
-    for (int i = 0; i < bytes; i += 2)
+#if CRC16_ECC240_TABLE_VARIANT == CRC16_ECC240_TABLE_SLICING8
+    for (; i + 8 <= bytes; i += 8)
+    {
+        // Convert data into a 64-bit word, with the running CRC over its top
+        uint64_t w = ((uint64_t)r << 48) ^
+            ((uint64_t)data[i] << 56) ^ ((uint64_t)data[i + 1] << 48) ^
+            ((uint64_t)data[i + 2] << 40) ^ ((uint64_t)data[i + 3] << 32) ^
+            ((uint64_t)data[i + 4] << 24) ^ ((uint64_t)data[i + 5] << 16) ^
+            ((uint64_t)data[i + 6] << 8) ^ (uint64_t)data[i + 7];
+
+        r = CRC16_ECC240_SLICE[5][w >> 56] ^ CRC16_ECC240_SLICE[4][(uint8_t)(w >> 48)] ^
+            CRC16_ECC240_SLICE[3][(uint8_t)(w >> 40)] ^ CRC16_ECC240_SLICE[2][(uint8_t)(w >> 32)] ^
+            CRC16_ECC240_SLICE[1][(uint8_t)(w >> 24)] ^ CRC16_ECC240_SLICE[0][(uint8_t)(w >> 16)] ^
+            CRC16_ECC240_REDUCE[1][(uint8_t)(w >> 8)] ^ CRC16_ECC240_REDUCE[0][(uint8_t)w];
+    }
+#endif
+
+    for (; i < bytes; i += 2)
     {
         // Convert data into a 16-bit word
         uint16_t w = (uint16_t)data[i + 1] | ((uint16_t)data[i] << 8);
@@ -110,33 +426,109 @@ extern "C" uint16_t crc16_ecc240_generate(const void* vdata, int bytes)
 //-----------------------------------------------------------------------------
 // crc16_ecc240_correct
 
-static uint16_t crc_backwards(uint16_t crc)
+/*
+    Single-bit residues.
+
+    Flipping the bit 'd' places from the end of a codeword changes the
+    remainder from crc16_ecc240_generate() by x^(d+16) mod P.  x has order
+    257 mod P, so these are distinct for every bit of a 32-byte codeword.
+
+    Built on first use, so tables in other files may be built from it
+    during static initialization.
+*/
+struct BitResidueTable
 {
-    // Run the CRC backwards
-    if (crc & 1)
-    {
-        crc = (crc >> 1) ^ (CRC16_ECC240_POLY >> 1);
-    }
-    else
+    uint16_t Residue[CRC16_ECC240_MAX_CODEWORD_BYTES * 8];
+
+    BitResidueTable()
     {
-        crc >>= 1;
+        uint32_t r = 0x5935; // x^16 mod P
+        for (int d = 0; d < CRC16_ECC240_MAX_CODEWORD_BYTES * 8; ++d)
+        {
+            Residue[d] = (uint16_t)r;
+            r <<= 1;
+            if (r & 0x10000)
+            {
+                r ^= CRC16_ECC240_POLY;
+            }
+        }
     }
-    return crc;
+};
+
+uint16_t BitResidue(int distance)
+{
+    static const BitResidueTable table;
+    return table.Residue[distance];
 }
 
-static int GetSingleErrorBitLocation(uint16_t crc, int bytes)
+/*
+    Syndrome classes.
+
+    The residue of a burst is the xor of the residues of its bits.  For one
+    bit and for the bursts 11, 101 and 111 these are all distinct in
+    codewords of up to 256 bits, so a table indexed by residue gives the
+    error and its distance for every codeword length: Only the range check
+    depends on the length.  Counting from the end also keeps the CRC field
+    at distances 0..15, so data and CRC bits get their own classes.
+
+    Every other residue is uncorrectable, which one lookup reports without
+    searching.  At 128 KB the table stays in L2 cache.
+*/
+struct SyndromeClassTable
 {
-    for (int i = 0; i < bytes * 8 + 16; i++)
+    // Class << 8 | distance of the bit furthest from the end
+    uint16_t Entry[0x10000];
+
+    SyndromeClassTable()
     {
-        crc = crc_backwards(crc);
+        for (int i = 0; i < 0x10000; ++i)
+        {
+            Entry[i] = CRC16_ECC240_CLASS_UNCORRECTABLE << 8;
+        }
+        Entry[0] = CRC16_ECC240_CLASS_CLEAN << 8;
 
-        if (crc == 1)
+        for (int d = 0; d < CRC16_ECC240_MAX_CODEWORD_BYTES * 8; ++d)
         {
-            return i; // Return the error location
+            const uint16_t r = BitResidue(d);
+            const int single = (d < 16) ? CRC16_ECC240_CLASS_CRC_BIT : CRC16_ECC240_CLASS_DATA_BIT;
+            Entry[r] = (uint16_t)((single << 8) | d);
+            if (d >= 1)
+            {
+                Entry[r ^ BitResidue(d - 1)] = (uint16_t)((CRC16_ECC240_CLASS_ADJACENT << 8) | d);
+            }
+            if (d >= 2)
+            {
+                Entry[r ^ BitResidue(d - 2)] = (uint16_t)((CRC16_ECC240_CLASS_SPLIT << 8) | d);
+                Entry[r ^ BitResidue(d - 1) ^ BitResidue(d - 2)] = (uint16_t)((CRC16_ECC240_CLASS_TRIPLE << 8) | d);
+            }
         }
     }
+};
+
+static const SyndromeClassTable SyndromeClasses;
 
-    return -1; // Not found
+/*
+    Returns the class of a codeword residue, and sets 'bitPosition' to the
+    first flipped bit of a codeword of 'totalBits', or -1 if there is none.
+*/
+static CRC16_ECC240_FORCE_INLINE int LookupResidue(uint16_t residue, int totalBits, int& bitPosition)
+{
+    const uint16_t entry = SyndromeClasses.Entry[residue];
+    const int errorClass = entry >> 8;
+    const int distance = entry & 0xff;
+
+    bitPosition = -1;
+    if (errorClass == CRC16_ECC240_CLASS_CLEAN || errorClass == CRC16_ECC240_CLASS_UNCORRECTABLE)
+    {
+        return errorClass;
+    }
+    if (distance >= totalBits)
+    {
+        return CRC16_ECC240_CLASS_UNCORRECTABLE; // Not within this codeword
+    }
+
+    bitPosition = totalBits - 1 - distance;
+    return errorClass;
 }
 
 extern "C" int crc16_ecc240_check(uint8_t* receivedData, int bytes, uint16_t receivedCRC)
@@ -148,31 +540,670 @@ extern "C" int crc16_ecc240_check(uint8_t* receivedData, int bytes, uint16_t rec
     if (errorSyndrome == 0)
     {
         // Already fine
+        RecordClean();
+        return 0;
+    }
+
+    // Look up the error, as if the CRC followed the data in a codeword.
+    // The bit position is in transmission order
+    int bitPosition;
+    int errorClass = LookupResidue(crc16_reduce(errorSyndrome), bytes * 8 + 16, bitPosition);
+
+    if (errorClass == CRC16_ECC240_CLASS_CRC_BIT)
+    {
+        // The error is in the received CRC, so the data is intact
+        RecordCorrected(bitPosition);
         return 0;
     }
 
-    // Try to find the single error bit location
-    int location = GetSingleErrorBitLocation(errorSyndrome, bytes);
-    if (location == -1)
+    if (errorClass != CRC16_ECC240_CLASS_DATA_BIT)
     {
-        // Not found
+        // Not a single-bit error
+        RecordUncorrectable();
         return -1;
     }
 
     // Correct the error
-    int dataByteOffset = ((14 + bytes * 8) - location) / 8;
-    int dataBitOffset = 7 - (((14 + bytes * 8) - location) % 8);
+    int dataByteOffset = bitPosition / 8;
+    int dataBitOffset = 7 - (bitPosition % 8);
     receivedData[dataByteOffset] ^= 1 << dataBitOffset;
 
     // Check if the CRC matches now
     if (crc16_ecc240_generate(receivedData, bytes) != receivedCRC)
     {
+        RecordMiscorrected();
+        return -2;
+    }
+
+    RecordCorrected(bitPosition);
+    return 0;
+}
+
+extern "C" void crc16_ecc240_encode_codeword(uint8_t* frame, int totalBytes)
+{
+    uint16_t crc = crc16_ecc240_generate(frame, totalBytes - 2);
+
+    frame[totalBytes - 2] = (uint8_t)(crc >> 8);
+    frame[totalBytes - 1] = (uint8_t)crc;
+}
+
+extern "C" int crc16_ecc240_check_codeword(uint8_t* frame, int totalBytes)
+{
+    // Remainder of the whole codeword, multiplied by x^16.
+    // The CRC is appended big-endian, so a clean codeword leaves zero
+    uint16_t residue = crc16_ecc240_generate(frame, totalBytes);
+    if (residue == 0)
+    {
+        // Already fine
+        RecordClean();
+        return 0;
+    }
+
+    // Look up the error directly: The residue is the codeword syndrome
+    int bitPosition;
+    int errorClass = LookupResidue(residue, totalBytes * 8, bitPosition);
+    if (errorClass != CRC16_ECC240_CLASS_DATA_BIT && errorClass != CRC16_ECC240_CLASS_CRC_BIT)
+    {
+        // Not a single-bit error
+        RecordUncorrectable();
+        return -1;
+    }
+
+    // Correct the error
+    frame[bitPosition / 8] ^= 0x80 >> (bitPosition % 8);
+
+    // Check if the codeword is valid now
+    if (crc16_ecc240_generate(frame, totalBytes) != 0)
+    {
+        RecordMiscorrected();
         return -2;
     }
 
+    RecordCorrected(bitPosition);
     return 0;
 }
 
+int ClassifyResidue(uint16_t residue, int totalBits, int& bitPosition)
+{
+    return LookupResidue(residue, totalBits, bitPosition);
+}
+
+extern "C" int crc16_ecc240_classify_codeword(const uint8_t* frame, int totalBytes, int* bitPosition)
+{
+    return LookupResidue(crc16_ecc240_generate(frame, totalBytes), totalBytes * 8, *bitPosition);
+}
+
+
+//-----------------------------------------------------------------------------
+// crc16_ecc240_check_constant
+
+/*
+    Single-bit syndromes by perfect hash.
+
+    A codeword residue from one bit error at distance d is x^(d+16) mod P.
+    Multiplying by this constant and keeping the top 12 bits gives a distinct
+    slot for each of the 256 distances a codeword can have, so a lookup is
+    one multiply, one load and one compare, with no probing.
+*/
+static const uint32_t kSingleBitHashMultiplier = 0x7c81c3dd;
+static const int kSingleBitHashBits = 12;
+
+static CRC16_ECC240_FORCE_INLINE uint32_t SingleBitHash(uint16_t residue)
+{
+    return (uint32_t)(residue * kSingleBitHashMultiplier) >> (32 - kSingleBitHashBits);
+}
+
+struct SingleBitTable
+{
+    // Residue in the low 16 bits, distance + 1 above it; 0 for unused slots
+    uint32_t Slot[1 << kSingleBitHashBits];
+
+    SingleBitTable()
+    {
+        memset(Slot, 0, sizeof(Slot));
+
+        for (int d = 0; d < CRC16_ECC240_MAX_CODEWORD_BYTES * 8; ++d)
+        {
+            const uint16_t r = BitResidue(d);
+            Slot[SingleBitHash(r)] = r | ((uint32_t)(d + 1) << 16);
+        }
+    }
+};
+
+static const SingleBitTable SingleBits;
+
+// All ones if x is zero, otherwise zero, without branching
+static CRC16_ECC240_FORCE_INLINE uint32_t MaskIfZero(uint32_t x)
+{
+    return (uint32_t)0 - (uint32_t)(((x | (0u - x)) >> 31) ^ 1);
+}
+
+/*
+    Returns the bit position of the error counted from the start of a
+    codeword of 'totalBits', and sets 'found' to all ones if the residue is
+    from a single-bit error in it, or zero otherwise.
+    With no error found, the position is 0 so it is always safe to index.
+*/
+static CRC16_ECC240_FORCE_INLINE uint32_t LocateConstant(uint16_t residue, uint32_t totalBits, uint32_t& found)
+{
+    const uint32_t slot = SingleBits.Slot[SingleBitHash(residue)];
+    const uint32_t distancePlus1 = slot >> 16;
+
+    // Matches, is an error at all, and lies within this codeword
+    uint32_t mask = MaskIfZero((slot & 0xffff) ^ residue) & ~MaskIfZero(residue);
+    mask &= (uint32_t)0 - (uint32_t)(distancePlus1 <= totalBits);
+
+    found = mask;
+    return (totalBits - distancePlus1) & mask;
+}
+
+extern "C" int crc16_ecc240_check_constant(uint8_t* receivedData, int bytes, uint16_t receivedCRC)
+{
+    // Bring the split syndrome to codeword form, as if the CRC followed
+    const uint16_t residue = crc16_reduce(crc16_ecc240_generate(receivedData, bytes) ^ receivedCRC);
+    const uint32_t totalBits = (uint32_t)bytes * 8 + 16;
+
+    uint32_t found;
+    const uint32_t bitPosition = LocateConstant(residue, totalBits, found);
+
+    // Errors in the CRC field leave the data alone
+    const uint32_t inData = found & ((uint32_t)0 - (uint32_t)(bitPosition < (uint32_t)bytes * 8));
+    const uint32_t byteOffset = (bitPosition >> 3) & inData;
+    receivedData[byteOffset] ^= (uint8_t)((0x80u >> (bitPosition & 7)) & inData);
+
+    // The flipped bit cancels the residue exactly, so there is nothing to
+    // re-verify: Failure is a non-zero residue that was not found
+    return -(int)(~MaskIfZero(residue) & ~found & 1);
+}
+
+extern "C" int crc16_ecc240_check_codeword_constant(uint8_t* frame, int totalBytes)
+{
+    const uint16_t residue = crc16_ecc240_generate(frame, totalBytes);
+
+    uint32_t found;
+    const uint32_t bitPosition = LocateConstant(residue, (uint32_t)totalBytes * 8, found);
+
+    frame[bitPosition >> 3] ^= (uint8_t)((0x80u >> (bitPosition & 7)) & found);
+
+    return -(int)(~MaskIfZero(residue) & ~found & 1);
+}
+
+
+//-----------------------------------------------------------------------------
+// crc16_ecc240_generate_iov
+
+extern "C" uint16_t crc16_ecc240_generate_iov(const crc16_ecc240_iovec_t* iov, int iovCount)
+{
+    uint16_t r = 0;
+
+    // High byte of a word split across two fragments
+    bool split = false;
+    uint16_t high = 0;
+
+    for (int i = 0; i < iovCount; ++i)
+    {
+        const uint8_t * CRC16_ECC240_RESTRICT data = iov[i].Data;
+        size_t bytes = iov[i].Bytes;
+
+        if (bytes == 0)
+        {
+            continue;
+        }
+
+        if (split)
+        {
+            r = crc16_reduce(r ^ (high | data[0]));
+            ++data;
+            --bytes;
+            split = false;
+        }
+
+        const uint8_t* end = data + (bytes & ~(size_t)1);
+        for (; data < end; data += 2)
+        {
+            // Convert data into a 16-bit word
+            uint16_t w = (uint16_t)data[1] | ((uint16_t)data[0] << 8);
+
+            r = crc16_reduce(r ^ w);
+        }
+
+        if (bytes & 1)
+        {
+            high = (uint16_t)data[0] << 8;
+            split = true;
+        }
+    }
+
+    return r;
+}
+
+extern "C" int crc16_ecc240_check_iov(const crc16_ecc240_iovec_t* iov, int iovCount, uint16_t receivedCRC)
+{
+    uint16_t errorSyndrome = crc16_ecc240_generate_iov(iov, iovCount) ^ receivedCRC;
+    if (errorSyndrome == 0)
+    {
+        // Already fine
+        RecordClean();
+        return 0;
+    }
+
+    int bytes = 0;
+    for (int i = 0; i < iovCount; ++i)
+    {
+        bytes += (int)iov[i].Bytes;
+    }
+
+    // Look up the error, as if the CRC followed the data in a codeword.
+    // The bit position is in transmission order
+    int bitPosition;
+    int errorClass = LookupResidue(crc16_reduce(errorSyndrome), bytes * 8 + 16, bitPosition);
+
+    if (errorClass == CRC16_ECC240_CLASS_CRC_BIT)
+    {
+        // The error is in the received CRC, so the data is intact
+        RecordCorrected(bitPosition);
+        return 0;
+    }
+
+    if (errorClass != CRC16_ECC240_CLASS_DATA_BIT)
+    {
+        // Not a single-bit error
+        RecordUncorrectable();
+        return -1;
+    }
+
+    // Find the fragment holding the bit and correct the error
+    int dataByteOffset = bitPosition / 8;
+    for (int i = 0; i < iovCount; ++i)
+    {
+        if ((size_t)dataByteOffset < iov[i].Bytes)
+        {
+            iov[i].Data[dataByteOffset] ^= 1 << (7 - (bitPosition % 8));
+            break;
+        }
+        dataByteOffset -= (int)iov[i].Bytes;
+    }
+
+    // Check if the CRC matches now
+    if (crc16_ecc240_generate_iov(iov, iovCount) != receivedCRC)
+    {
+        RecordMiscorrected();
+        return -2;
+    }
+
+    RecordCorrected(bitPosition);
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// crc16_ecc240_combine
+
+// a * b mod CRC16_ECC240_POLY
+static uint16_t MulModP(uint16_t a, uint16_t b)
+{
+    // Carry-less 16x16 product
+    uint32_t p = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        if (b >> i & 1)
+        {
+            p ^= (uint32_t)a << i;
+        }
+    }
+
+    // High word times x^16 folds down through the reduction table
+    return (uint16_t)p ^ crc16_reduce((uint16_t)(p >> 16));
+}
+
+// x^n mod CRC16_ECC240_POLY
+static uint16_t XPowModP(uint64_t n)
+{
+    // x has order 257 modulo the polynomial
+    n %= 257;
+
+    // Square-and-multiply
+    uint16_t result = 1, square = 2;
+    while (n != 0)
+    {
+        if (n & 1)
+        {
+            result = MulModP(result, square);
+        }
+        square = MulModP(square, square);
+        n >>= 1;
+    }
+    return result;
+}
+
+extern "C" uint16_t crc16_ecc240_combine(uint16_t crcA, uint16_t crcB, size_t bytesB)
+{
+    // CRC(A || B) = CRC(A) * x^(8 * bytesB) + CRC(B)
+    return MulModP(crcA, XPowModP((uint64_t)bytesB * 8)) ^ crcB;
+}
+
+
+//-----------------------------------------------------------------------------
+// CPU Features
+
+struct CpuFeatures
+{
+    bool SSSE3 = false;
+    bool CLMUL = false;
+
+    CpuFeatures()
+    {
+#ifdef CRC16_ECC240_TARGET_CLMUL
+        const unsigned kSSSE3 = 1 << 9, kPCLMULQDQ = 1 << 1;
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        unsigned ecx = (unsigned)info[2];
+#else
+        unsigned eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        {
+            return;
+        }
+#endif
+        SSSE3 = (ecx & kSSSE3) != 0;
+        CLMUL = SSSE3 && (ecx & kPCLMULQDQ) != 0;
+#endif // CRC16_ECC240_TARGET_CLMUL
+    }
+};
+
+// Zero-initialized (no SIMD) until constructed, so early callers fall back safely
+static const CpuFeatures Cpu;
+
+bool CpuHasSSSE3()
+{
+    return Cpu.SSSE3;
+}
+
+bool CpuHasCLMUL()
+{
+    return Cpu.CLMUL;
+}
+
+
+//-----------------------------------------------------------------------------
+// crc16_ecc240_verify_many
+
+#ifdef CRC16_ECC240_TARGET_CLMUL
+
+/*
+    x^n mod CRC16_ECC240_POLY, used to fold the high parts of a 256-bit
+    codeword down onto the low 64 bits.
+*/
+static const uint64_t CRC16_ECC240_X64 = 0x0c29;
+static const uint64_t CRC16_ECC240_X128 = 0xc68a;
+static const uint64_t CRC16_ECC240_X192 = 0x70b0;
+
+
+/*
+    Remainder of a 32-byte big-endian block divided by CRC16_ECC240_POLY.
+
+    Each 64-bit quarter of the block is multiplied by x^n mod P for its bit
+    offset n, which leaves a sum of at most 79 bits.  The top 15 bits of that
+    are folded once more to get a 64-bit value with the same remainder, and the
+    reduction table finishes the last 48 bits.
+
+    With clearCRC set, the last two bytes are treated as zero.  The remainder
+    is then the CRC of the first 30 bytes, ready to be appended.
+*/
+CRC16_ECC240_TARGET_CLMUL static uint16_t Fold256(const uint8_t* block, bool clearCRC)
+{
+    // Byte-reverse so that the first byte in memory is the most significant
+    const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), reverse);
+    __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16)), reverse);
+    if (clearCRC)
+    {
+        lo = _mm_andnot_si128(_mm_set_epi32(0, 0, 0, 0xffff), lo);
+    }
+
+    const __m128i k192_128 = _mm_set_epi64x(CRC16_ECC240_X192, CRC16_ECC240_X128);
+    const __m128i k64 = _mm_set_epi64x(0, CRC16_ECC240_X64);
+
+    __m128i sum = _mm_clmulepi64_si128(hi, k192_128, 0x11);
+    sum = _mm_xor_si128(sum, _mm_clmulepi64_si128(hi, k192_128, 0x00));
+    sum = _mm_xor_si128(sum, _mm_clmulepi64_si128(lo, k64, 0x01));
+    sum = _mm_xor_si128(sum, _mm_move_epi64(lo));
+
+    // Fold bits 64..78 onto the low 64 bits
+    sum = _mm_xor_si128(sum, _mm_clmulepi64_si128(sum, k64, 0x01));
+
+    uint64_t v;
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(&v), sum);
+
+    uint16_t r = crc16_reduce((uint16_t)(v >> 48));
+    r = crc16_reduce(r ^ (uint16_t)(v >> 32));
+    r = crc16_reduce(r ^ (uint16_t)(v >> 16));
+    return r ^ (uint16_t)v;
+}
+
+// Returns a bitmap word flagging the 32-byte codewords that are not clean
+CRC16_ECC240_TARGET_CLMUL static uint64_t VerifyCLMUL(const uint8_t* frame, size_t stride, int count)
+{
+    uint64_t word = 0;
+    for (int j = 0; j < count; ++j, frame += stride)
+    {
+        word |= (uint64_t)(Fold256(frame, false) != 0) << j;
+    }
+    return word;
+}
+
+// Append the CRC to each 32-byte codeword
+CRC16_ECC240_TARGET_CLMUL static void EncodeCLMUL(uint8_t* frame, size_t stride, size_t count)
+{
+    for (size_t j = 0; j < count; ++j, frame += stride)
+    {
+        uint16_t crc = Fold256(frame, true);
+        frame[30] = (uint8_t)(crc >> 8);
+        frame[31] = (uint8_t)crc;
+    }
+}
+
+// CRC of the first 30 bytes of each slot
+CRC16_ECC240_TARGET_CLMUL static void BlockEncodeCLMUL(const uint8_t* slot, uint16_t* crcs, int count)
+{
+    for (int j = 0; j < count; ++j, slot += CRC16_ECC240_BLOCK_SLOT_BYTES)
+    {
+        crcs[j] = Fold256(slot, true);
+    }
+}
+
+// Returns a bitmap word flagging the slots that do not match their CRC
+CRC16_ECC240_TARGET_CLMUL static uint64_t BlockVerifyCLMUL(const uint8_t* slot, const uint16_t* crcs, int count)
+{
+    uint64_t word = 0;
+    for (int j = 0; j < count; ++j, slot += CRC16_ECC240_BLOCK_SLOT_BYTES)
+    {
+        word |= (uint64_t)(Fold256(slot, true) != crcs[j]) << j;
+    }
+    return word;
+}
+
+#endif // CRC16_ECC240_TARGET_CLMUL
+
+extern "C" void crc16_ecc240_encode_many(uint8_t* frames, int totalBytes, size_t stride, size_t count)
+{
+#ifdef CRC16_ECC240_TARGET_CLMUL
+    if (totalBytes == 32 && CpuHasCLMUL())
+    {
+        EncodeCLMUL(frames, stride, count);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < count; ++i, frames += stride)
+    {
+        crc16_ecc240_encode_codeword(frames, totalBytes);
+    }
+}
+
+extern "C" int crc16_ecc240_verify_many(const uint8_t* frames, int totalBytes, size_t stride,
+                                        int count, uint64_t* bitmap)
+{
+    int failures = 0;
+
+    for (int i = 0; i < count; i += 64)
+    {
+        const int end = (count - i < 64) ? (count - i) : 64;
+        const uint8_t* frame = frames + i * stride;
+        uint64_t word = 0;
+
+#ifdef CRC16_ECC240_TARGET_CLMUL
+        if (totalBytes == 32 && CpuHasCLMUL())
+        {
+            word = VerifyCLMUL(frame, stride, end);
+        }
+        else
+#endif
+        {
+            for (int j = 0; j < end; ++j, frame += stride)
+            {
+                word |= (uint64_t)(crc16_ecc240_generate(frame, totalBytes) != 0) << j;
+            }
+        }
+
+        bitmap[i / 64] = word;
+
+        // Count bits set: Failures are rare, so this loop is usually skipped
+        for (; word; word &= word - 1)
+        {
+            ++failures;
+        }
+    }
+
+    RecordClean(count - failures);
+    return failures;
+}
+
+extern "C" int crc16_ecc240_correct_many(uint8_t* frames, int totalBytes, size_t stride,
+                                         int count, uint64_t* bitmap)
+{
+    int failures = 0;
+
+    for (int i = 0; i < count; i += 64)
+    {
+        uint64_t word = bitmap[i / 64];
+        uint64_t pending = word;
+
+        for (int j = 0; pending; ++j, pending >>= 1)
+        {
+            if (pending & 1)
+            {
+                if (0 == crc16_ecc240_check_codeword(frames + (i + j) * stride, totalBytes))
+                {
+                    word ^= (uint64_t)1 << j;
+                }
+                else
+                {
+                    ++failures;
+                }
+            }
+        }
+
+        bitmap[i / 64] = word;
+    }
+
+    return failures;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// crc16_ecc240_block_verify
+
+extern "C" void crc16_ecc240_block_encode(crc16_ecc240_block_t* block)
+{
+#ifdef CRC16_ECC240_TARGET_CLMUL
+    if (block->DataBytes == 30 && CpuHasCLMUL())
+    {
+        BlockEncodeCLMUL(block->Data, block->CRCs, block->Count);
+        return;
+    }
+#endif
+
+    const uint8_t* slot = block->Data;
+    for (int i = 0; i < block->Count; ++i, slot += CRC16_ECC240_BLOCK_SLOT_BYTES)
+    {
+        block->CRCs[i] = crc16_ecc240_generate(slot, block->DataBytes);
+    }
+}
+
+extern "C" int crc16_ecc240_block_verify(const crc16_ecc240_block_t* block, uint64_t* bitmap)
+{
+    const int count = block->Count;
+    int failures = 0;
+
+    for (int i = 0; i < count; i += 64)
+    {
+        const int end = (count - i < 64) ? (count - i) : 64;
+        const uint8_t* slot = block->Data + i * CRC16_ECC240_BLOCK_SLOT_BYTES;
+        const uint16_t* crcs = block->CRCs + i;
+        uint64_t word = 0;
+
+#ifdef CRC16_ECC240_TARGET_CLMUL
+        if (block->DataBytes == 30 && CpuHasCLMUL())
+        {
+            word = BlockVerifyCLMUL(slot, crcs, end);
+        }
+        else
+#endif
+        {
+            for (int j = 0; j < end; ++j, slot += CRC16_ECC240_BLOCK_SLOT_BYTES)
+            {
+                word |= (uint64_t)(crc16_ecc240_generate(slot, block->DataBytes) != crcs[j]) << j;
+            }
+        }
+
+        bitmap[i / 64] = word;
+
+        // Count bits set: Failures are rare, so this loop is usually skipped
+        for (; word; word &= word - 1)
+        {
+            ++failures;
+        }
+    }
+
+    RecordClean(count - failures);
+    return failures;
+}
+
+extern "C" int crc16_ecc240_block_correct(crc16_ecc240_block_t* block, uint64_t* bitmap)
+{
+    int failures = 0;
+
+    for (int i = 0; i < block->Count; i += 64)
+    {
+        uint64_t word = bitmap[i / 64];
+        uint64_t pending = word;
+
+        for (int j = 0; pending; ++j, pending >>= 1)
+        {
+            if (pending & 1)
+            {
+                uint8_t* slot = block->Data + (i + j) * CRC16_ECC240_BLOCK_SLOT_BYTES;
+                if (0 == crc16_ecc240_check(slot, block->DataBytes, block->CRCs[i + j]))
+                {
+                    // The data is right now, so this also repairs a bad CRC
+                    block->CRCs[i + j] = crc16_ecc240_generate(slot, block->DataBytes);
+                    word ^= (uint64_t)1 << j;
+                }
+                else
+                {
+                    ++failures;
+                }
+            }
+        }
+
+        bitmap[i / 64] = word;
+    }
+
+    return failures;
+}
 
 extern "C" int crc16_ecc240_self_test()
 {
@@ -189,6 +1220,22 @@ extern "C" int crc16_ecc240_self_test()
         return -1;
     }
 
+#ifdef CRC16_ECC240_TARGET_CLMUL
+    // The folded remainder times x^16 must match the table-driven CRC
+    if (CpuHasCLMUL())
+    {
+        uint8_t block[32];
+        for (int i = 0; i < 32; ++i)
+            block[i] = (uint8_t)(i * 37 + 11);
+
+        if (crc16_reduce(Fold256(block, false)) != crc16_ecc240_generate(block, 32) ||
+            Fold256(block, true) != crc16_ecc240_generate(block, 30))
+        {
+            return -1;
+        }
+    }
+#endif
+
     return 0;
 }
 
@@ -268,6 +1315,40 @@ void GenerateAndPrint_CRC16_ECC240_REDUCTION_TABLE()
     cout << "};" << endl;
 }
 
+void GenerateAndPrint_CRC16_ECC240_SLICE_TABLE()
+{
+    cout << "const uint16_t CRC16_ECC240_SLICE[6][256] = {" << endl;
+    for (int k = 0; k < 6; ++k)
+    {
+        cout << (k == 0 ? "    {" : "    }, {") << endl << "        ";
+        for (int seen = 0, i = 0; i < 256; ++i)
+        {
+            uint32_t t = i;
+
+            for (int j = 0; j < 32 + 8 * k; ++j)
+            {
+                t <<= 1;
+                if (t >= 0x10000)
+                {
+                    t ^= CRC16_ECC240_POLY;
+                }
+            }
+
+            if (t == 0)
+            {
+                cout << "0, ";
+            }
+            else
+            {
+                cout << "0x" << hex << t << dec << ", ";
+            }
+            if ((++seen & 15) == 0) cout << endl << "        ";
+        }
+    }
+    cout << "    }" << endl;
+    cout << "};" << endl;
+}
+
 #endif // CRC16_ENABLE_TABLE_GENERATION_CODE
 
 
@@ -50,6 +50,31 @@
 */
 #define CRC16_ECC240_POLY 0x15935
 
+// Largest codeword supported for correction: 30 data bytes + 2 CRC bytes
+#define CRC16_ECC240_MAX_CODEWORD_BYTES 32
+
+/*
+    CRC16_ECC240_TABLE_VARIANT
+
+    Selects the lookup table footprint of crc16_ecc240_generate(), trading
+    cache space for speed.  All variants produce identical results.
+
+    CRC16_ECC240_TABLE_BITWISE : No table, one bit at a time
+    CRC16_ECC240_TABLE_NIBBLE : 32 bytes, one nibble at a time
+    CRC16_ECC240_TABLE_BYTE : 1 KB, two bytes at a time (default)
+    CRC16_ECC240_TABLE_SLICING8 : 4 KB, eight bytes at a time
+
+    Define it the same way for every file that includes this header.
+*/
+#define CRC16_ECC240_TABLE_BITWISE 0
+#define CRC16_ECC240_TABLE_NIBBLE 1
+#define CRC16_ECC240_TABLE_BYTE 2
+#define CRC16_ECC240_TABLE_SLICING8 3
+
+#ifndef CRC16_ECC240_TABLE_VARIANT
+#define CRC16_ECC240_TABLE_VARIANT CRC16_ECC240_TABLE_BYTE
+#endif
+
 
 //-----------------------------------------------------------------------------
 // Platform-Specific Definitions
@@ -70,8 +95,54 @@
     // Compiler-specific 128-bit SIMD register keyword
     #define CRC16_ECC240_M128 __m128i
 
+    // Compiler-specific thread-local storage keyword
+    #define CRC16_ECC240_THREAD_LOCAL __declspec(thread)
+
     // Compiler-specific SSE headers
     #include <wmmintrin.h> // _mm_clmulepi64_si128
+    #include <tmmintrin.h> // _mm_shuffle_epi8
+    #include <intrin.h> // __cpuid
+
+    // Compiler-specific attribute to enable CLMUL and SSSE3 for one function
+    #define CRC16_ECC240_TARGET_CLMUL
+
+    // Compiler-specific attribute to enable SSE2 for one function
+    #define CRC16_ECC240_TARGET_SSE2
+
+    // Compiler-specific attribute to enable SSSE3 for one function
+    #define CRC16_ECC240_TARGET_SSSE3
+
+#elif defined(__GNUC__)
+
+    // Compiler-specific C++11 restrict keyword
+    #define CRC16_ECC240_RESTRICT __restrict__
+
+    // Compiler-specific force inline keyword
+    #define CRC16_ECC240_FORCE_INLINE inline __attribute__((always_inline))
+
+    // Compiler-specific alignment keyword
+    #define CRC16_ECC240_ALIGNED __attribute__((aligned(16)))
+
+    // Compiler-specific thread-local storage keyword
+    #define CRC16_ECC240_THREAD_LOCAL __thread
+
+    #if defined(__x86_64__) || defined(__i386__)
+
+        // Compiler-specific SSE headers
+        #include <wmmintrin.h> // _mm_clmulepi64_si128
+        #include <tmmintrin.h> // _mm_shuffle_epi8
+        #include <cpuid.h> // __get_cpuid
+
+        // Compiler-specific attribute to enable CLMUL and SSSE3 for one function
+        #define CRC16_ECC240_TARGET_CLMUL __attribute__((target("pclmul,ssse3")))
+
+        // Compiler-specific attribute to enable SSE2 for one function
+        #define CRC16_ECC240_TARGET_SSE2 __attribute__((target("sse2")))
+
+        // Compiler-specific attribute to enable SSSE3 for one function
+        #define CRC16_ECC240_TARGET_SSSE3 __attribute__((target("ssse3")))
+
+    #endif
 
 #else
 
@@ -79,6 +150,9 @@
 
 #endif
 
+// Size of a cache line, used to pad per-thread data against false sharing
+#define CRC16_ECC240_CACHE_LINE_BYTES 64
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -104,12 +178,278 @@ uint16_t crc16_ecc240_generate(const void* data, int bytes);
 // Returns 0 on success.
 // Returns non-zero on failure to correct the data.
 //
-// Single-bit error correction based on running CRC backwards and insights
-// from this paper:
+// Single-bit error correction based on insights from this paper:
 //   "Selected CRC Polynomials Can Correct Errors and Thus Reduce Retransmission"
 //   by Travis Mandel, Jens Mache
+//
+// The error is located with one lookup of the syndrome in a 128 KB table,
+// so frames that cannot be corrected are rejected without searching.
 int crc16_ecc240_check(uint8_t* receivedData, int bytes, uint16_t receivedCRC);
 
+// Append the CRC16 to the data in a frame, producing a codeword.
+//
+// The CRC is written big-endian into the last two bytes of the frame.
+// Dividing the whole codeword by the CRC polynomial then leaves no remainder.
+//
+// Precondition: frame points to a valid buffer that is 'totalBytes' in length
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+void crc16_ecc240_encode_codeword(uint8_t* frame, int totalBytes);
+
+// Check a codeword produced by crc16_ecc240_encode_codeword().
+// May modify the frame to correct errors.
+//
+// This runs the division over the data and CRC together, so a clean frame
+// costs a single pass with no separate CRC compare.  A single bit error
+// anywhere in the codeword is corrected, including in the CRC field.
+//
+// Precondition: frame points to a valid buffer that is 'totalBytes' in length
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+//
+// Returns 0 on success.
+// Returns non-zero on failure to correct the frame.
+int crc16_ecc240_check_codeword(uint8_t* frame, int totalBytes);
+
+/*
+    Error classes from crc16_ecc240_classify_codeword()
+
+    CRC16_ECC240_CLASS_CLEAN : No error
+    CRC16_ECC240_CLASS_DATA_BIT : One flipped bit in the data
+    CRC16_ECC240_CLASS_CRC_BIT : One flipped bit in the CRC field
+    CRC16_ECC240_CLASS_ADJACENT : Two neighboring flipped bits
+    CRC16_ECC240_CLASS_UNCORRECTABLE : Anything else
+    CRC16_ECC240_CLASS_SPLIT : Two flipped bits with one good bit between
+    CRC16_ECC240_CLASS_TRIPLE : Three neighboring flipped bits
+*/
+#define CRC16_ECC240_CLASS_CLEAN 0
+#define CRC16_ECC240_CLASS_DATA_BIT 1
+#define CRC16_ECC240_CLASS_CRC_BIT 2
+#define CRC16_ECC240_CLASS_ADJACENT 3
+#define CRC16_ECC240_CLASS_UNCORRECTABLE 4
+#define CRC16_ECC240_CLASS_SPLIT 5
+#define CRC16_ECC240_CLASS_TRIPLE 6
+
+// Classify the error in a codeword without modifying it.
+//
+// This is the lookup the check functions use, exposed for callers that
+// want to handle short bursts themselves.  The check functions correct
+// only the single-bit classes, since correcting bursts as well makes it
+// more likely that a heavily damaged frame is miscorrected.
+//
+// For an error, 'bitPosition' is set to the position of the flipped bit in
+// transmission order, counted from the start of the frame.  For a burst it
+// is the first flipped bit.  Otherwise it is set to -1.
+//
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+//
+// Returns one of the CRC16_ECC240_CLASS_* values.
+int crc16_ecc240_classify_codeword(const uint8_t* frame, int totalBytes, int* bitPosition);
+
+
+//-----------------------------------------------------------------------------
+// Constant-Latency Checking
+//
+// The functions above return quickly for clean frames and take longer to
+// locate an error.  These versions always do the same work for a given
+// length: One CRC pass, one lookup in a 16 KB table of single-bit syndromes,
+// and one masked write that flips a bit only when a correctable error was
+// found.  Whether a frame was clean, corrected or uncorrectable does not
+// change the instructions executed, so worst-case time can be budgeted
+// from the clean case.
+//
+// They do not update the statistics counters, since that needs branches.
+
+// Same contract as crc16_ecc240_check(), with constant latency
+//
+// Precondition: bytes >= 2; bytes is even; bytes <= 30
+//
+// Returns 0 on success, or -1 if the data could not be corrected.
+int crc16_ecc240_check_constant(uint8_t* receivedData, int bytes, uint16_t receivedCRC);
+
+// Same contract as crc16_ecc240_check_codeword(), with constant latency
+//
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+//
+// Returns 0 on success, or -1 if the frame could not be corrected.
+int crc16_ecc240_check_codeword_constant(uint8_t* frame, int totalBytes);
+
+
+//-----------------------------------------------------------------------------
+// Bulk Encoding and Verification
+//
+// Most frames arrive clean, so bulk checking is split into two passes:
+// A streaming pass that only computes syndromes and flags failures in a
+// bitmap, and a second pass that runs the branchy correction code on the
+// few flagged frames.
+//
+// Frames are codewords as produced by crc16_ecc240_encode_codeword(), laid
+// out 'stride' bytes apart.  The bitmap holds one bit per frame, with frame i
+// at bit (i % 64) of bitmap[i / 64], and must have room for (count + 63) / 64
+// words.
+//
+// 32-byte codewords are folded with carry-less multiplies when the CPU
+// supports CLMUL, and other sizes fall back to the table-driven CRC.
+
+// Append the CRC to each frame, as crc16_ecc240_encode_codeword() would.
+//
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+// Precondition: stride >= totalBytes
+void crc16_ecc240_encode_many(uint8_t* frames, int totalBytes, size_t stride, size_t count);
+
+// Flag frames that fail the CRC check.  Does not modify the frames.
+//
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+// Precondition: stride >= totalBytes
+//
+// Returns the number of frames flagged in the bitmap.
+int crc16_ecc240_verify_many(const uint8_t* frames, int totalBytes, size_t stride,
+                             int count, uint64_t* bitmap);
+
+// Attempt to correct the frames flagged by crc16_ecc240_verify_many().
+// Frames that are corrected have their bit cleared in the bitmap.
+//
+// Returns the number of frames that are still flagged.
+int crc16_ecc240_correct_many(uint8_t* frames, int totalBytes, size_t stride,
+                              int count, uint64_t* bitmap);
+
+
+//-----------------------------------------------------------------------------
+// Frame Blocks
+//
+// Struct-of-arrays storage for batch kernels: The data of each frame sits in
+// its own 32-byte slot, with slots starting on a 64-byte boundary, and the
+// CRCs are kept in a separate contiguous array.  Full-size frames are then
+// exactly one aligned 32-byte load each.  Blocks are allocated in bulk by
+// crc16_ecc240_pool.h.
+//
+// 30-byte frames use carry-less multiplies when the CPU supports CLMUL, and
+// other sizes fall back to the table-driven CRC.
+
+// Bytes between the starts of successive frames in a block
+#define CRC16_ECC240_BLOCK_SLOT_BYTES 32
+
+typedef struct crc16_ecc240_block_t
+{
+    // Frame data, CRC16_ECC240_BLOCK_SLOT_BYTES apart, 64-byte aligned
+    uint8_t* Data;
+
+    // CRC of each frame
+    uint16_t* CRCs;
+
+    // Frames in use and frames allocated
+    int Count;
+    int Capacity;
+
+    // Data bytes per frame: Even and at most 30
+    int DataBytes;
+} crc16_ecc240_block_t;
+
+// Compute the CRC of every frame in the block into block->CRCs.
+void crc16_ecc240_block_encode(crc16_ecc240_block_t* block);
+
+// Flag frames whose data does not match their CRC.  Does not modify the block.
+// The bitmap is laid out as for crc16_ecc240_verify_many().
+//
+// Returns the number of frames flagged in the bitmap.
+int crc16_ecc240_block_verify(const crc16_ecc240_block_t* block, uint64_t* bitmap);
+
+// Attempt to correct the frames flagged by crc16_ecc240_block_verify().
+// Frames that are corrected have their bit cleared in the bitmap, and their
+// stored CRC is repaired if the error was in the CRC.
+//
+// Returns the number of frames that are still flagged.
+int crc16_ecc240_block_correct(crc16_ecc240_block_t* block, uint64_t* bitmap);
+
+
+//-----------------------------------------------------------------------------
+// Buffers
+
+// One contiguous piece of a scatter-gather list
+typedef struct crc16_ecc240_iovec_t
+{
+    uint8_t* Data;
+    size_t Bytes;
+} crc16_ecc240_iovec_t;
+
+
+// Compute the CRC16 of data split across several buffers, as if they were
+// concatenated.  Fragments may have any length, including odd lengths that
+// split a 16-bit word between two buffers.
+//
+// Precondition: The total length is even
+//
+// Returns the calculated CRC
+uint16_t crc16_ecc240_generate_iov(const crc16_ecc240_iovec_t* iov, int iovCount);
+
+// crc16_ecc240_check() for data split across several buffers.
+// May modify the data in the buffers to correct errors.
+//
+// Precondition: The total length is even, at least 2 and at most 30 bytes
+//
+// Returns 0 on success.
+// Returns non-zero on failure to correct the data.
+int crc16_ecc240_check_iov(const crc16_ecc240_iovec_t* iov, int iovCount, uint16_t receivedCRC);
+
+
+//-----------------------------------------------------------------------------
+// Combining
+
+// Compute the CRC16 of A followed by B from the CRC16 of each part, without
+// reading the data again.  'bytesB' is the length of B.
+//
+// Precondition: The length of A is even
+//
+// Returns the CRC of the concatenation
+uint16_t crc16_ecc240_combine(uint16_t crcA, uint16_t crcB, size_t bytesB);
+
+
+//-----------------------------------------------------------------------------
+// Statistics
+//
+// Every call to crc16_ecc240_check() is tallied in counters owned by the
+// calling thread, so the hot path never touches a shared cache line.
+// A snapshot merges the counters of all threads that have used the library.
+//
+// Define CRC16_ECC240_DISABLE_STATS when building crc16_ecc240.cpp to compile
+// the counters out entirely.  The API below remains and reports zeroes.
+
+//#define CRC16_ECC240_DISABLE_STATS
+
+// Number of corrected bit position buckets: 240 data bits + 16 CRC bits
+#define CRC16_ECC240_STATS_BIT_POSITIONS 256
+
+typedef struct crc16_ecc240_stats_t
+{
+    // Frames that arrived without errors
+    uint64_t Clean;
+
+    // Frames that had a single bit error corrected
+    uint64_t Corrected;
+
+    // Frames rejected because the error could not be located (returned -1)
+    uint64_t Uncorrectable;
+
+    // Frames rejected because the correction did not verify (returned -2)
+    uint64_t Miscorrected;
+
+    // Histogram of corrected bit positions.
+    // Position is the bit index in transmission order: Data bits first, most
+    // significant bit of each byte first, followed by the 16 bits of the CRC.
+    uint64_t CorrectedBits[CRC16_ECC240_STATS_BIT_POSITIONS];
+} crc16_ecc240_stats_t;
+
+// Sum the counters from all threads into the provided structure.
+// The result is a consistent-enough view for monitoring; counters that are
+// being updated concurrently may be off by the calls in flight.
+void crc16_ecc240_stats_snapshot(crc16_ecc240_stats_t* stats);
+
+// Accumulate the counters in 'from' into 'to'.
+// Useful for combining snapshots taken from several processes or intervals.
+void crc16_ecc240_stats_merge(crc16_ecc240_stats_t* to, const crc16_ecc240_stats_t* from);
+
+// Reset the counters of all threads to zero.
+// Not atomic with respect to calls in flight on other threads.
+void crc16_ecc240_stats_reset();
+
 
 //-----------------------------------------------------------------------------
 // Extra Tools
@@ -123,13 +463,44 @@ int crc16_ecc240_self_test();
 #ifdef CRC16_ENABLE_TABLE_GENERATION_CODE
 
     void GenerateAndPrint_CRC16_ECC240_REDUCTION_TABLE();
+    void GenerateAndPrint_CRC16_ECC240_SLICE_TABLE();
 
 #endif // CRC16_ENABLE_TABLE_GENERATION_CODE
 
 
 #ifdef __cplusplus
 }
-#endif
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// CPU Features
+
+// True if the SSSE3 code paths may run on this CPU
+bool CpuHasSSSE3();
+
+// True if the CLMUL (and SSSE3) code paths may run on this CPU
+bool CpuHasCLMUL();
+
+
+//-----------------------------------------------------------------------------
+// Syndrome Tables
+
+// Codeword residue of a single bit error 'distance' bits from the end of a
+// codeword: x^(distance+16) mod P
+//
+// Precondition: 0 <= distance < CRC16_ECC240_MAX_CODEWORD_BYTES * 8
+uint16_t BitResidue(int distance);
+
+// crc16_ecc240_classify_codeword() for a residue already computed over a
+// codeword of 'totalBits'
+int ClassifyResidue(uint16_t residue, int totalBits, int& bitPosition);
+
+
+} // namespace crc16ecc240
+
+#endif // __cplusplus
 
 
 #endif // CRC16_ECC240_h
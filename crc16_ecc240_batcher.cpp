@@ -0,0 +1,305 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_batcher.h"
+
+#include <string.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// Batcher
+
+struct BatchRequest
+{
+    uint8_t* Frame;
+    crc16_ecc240_batcher_done_t Done;
+    void* Context;
+    bool Generate;
+};
+
+/*
+    Requests queue under a lock.  The flusher is woken by the first request
+    of a batch and by the one that fills it, not by every submit, and
+    otherwise sleeps until the oldest request reaches its deadline.
+*/
+class Batcher
+{
+public:
+    Batcher(int totalBytes, int maxBatch, int maxDelayUsec)
+        : TotalBytes(totalBytes)
+        , MaxBatch(maxBatch)
+        , MaxDelay(std::chrono::microseconds(maxDelayUsec))
+        , Terminating(false)
+        , Staging((size_t)maxBatch * totalBytes)
+        , Bitmap(((size_t)maxBatch + 63) / 64)
+    {
+        Pending.reserve(maxBatch);
+        Working.reserve(maxBatch);
+        Thread = std::thread(&Batcher::Loop, this);
+    }
+
+    ~Batcher()
+    {
+        {
+            std::lock_guard<std::mutex> locker(Lock);
+            Terminating = true;
+        }
+        Arrived.notify_one();
+        Thread.join();
+    }
+
+    int Submit(uint8_t* frame, crc16_ecc240_batcher_done_t done, void* context, bool generate)
+    {
+        BatchRequest request;
+        request.Frame = frame;
+        request.Done = done;
+        request.Context = context;
+        request.Generate = generate;
+
+        bool wake;
+        {
+            std::lock_guard<std::mutex> locker(Lock);
+            if (Terminating)
+            {
+                return -1;
+            }
+
+            if (Pending.empty())
+            {
+                Oldest = std::chrono::steady_clock::now();
+            }
+            try
+            {
+                Pending.push_back(request);
+            }
+            catch (...)
+            {
+                return -1; // Out of memory
+            }
+            wake = (Pending.size() == 1 || Pending.size() == (size_t)MaxBatch);
+        }
+
+        if (wake)
+        {
+            Arrived.notify_one();
+        }
+        return 0;
+    }
+
+private:
+    const int TotalBytes;
+    const int MaxBatch;
+    const std::chrono::microseconds MaxDelay;
+
+    std::mutex Lock;
+    std::condition_variable Arrived;
+    std::vector<BatchRequest> Pending;
+    std::chrono::steady_clock::time_point Oldest;
+    bool Terminating;
+
+    // Used only by the flusher thread
+    std::vector<BatchRequest> Working;
+    std::vector<uint8_t> Staging;
+    std::vector<uint64_t> Bitmap;
+    std::thread Thread;
+
+    void Loop()
+    {
+        std::unique_lock<std::mutex> locker(Lock);
+
+        for (;;)
+        {
+            while (Pending.empty() && !Terminating)
+            {
+                Arrived.wait(locker);
+            }
+            if (Pending.empty())
+            {
+                break; // Terminating with nothing left to do
+            }
+
+            // Wait for a full batch or the oldest request's deadline
+            const std::chrono::steady_clock::time_point deadline = Oldest + MaxDelay;
+            while (Pending.size() < (size_t)MaxBatch && !Terminating &&
+                   std::chrono::steady_clock::now() < deadline)
+            {
+                Arrived.wait_until(locker, deadline);
+            }
+
+            // Take one batch; any more start a new one at once
+            const size_t take = Pending.size() < (size_t)MaxBatch ? Pending.size() : (size_t)MaxBatch;
+            Working.assign(Pending.begin(), Pending.begin() + take);
+            Pending.erase(Pending.begin(), Pending.begin() + take);
+
+            locker.unlock();
+            Flush();
+            locker.lock();
+        }
+    }
+
+    // Run the batch through the bulk kernels and complete each request
+    void Flush()
+    {
+        const int n = TotalBytes;
+        int checks = 0;
+
+        // Checks first in the staging area, then generates after them
+        for (size_t i = 0; i < Working.size(); ++i)
+        {
+            if (!Working[i].Generate)
+            {
+                memcpy(&Staging[checks++ * n], Working[i].Frame, n);
+            }
+        }
+        int generates = 0;
+        for (size_t i = 0; i < Working.size(); ++i)
+        {
+            if (Working[i].Generate)
+            {
+                memcpy(&Staging[(checks + generates++) * n], Working[i].Frame, n);
+            }
+        }
+
+        if (checks > 0)
+        {
+            if (crc16_ecc240_verify_many(&Staging[0], n, n, checks, &Bitmap[0]) > 0)
+            {
+                crc16_ecc240_correct_many(&Staging[0], n, n, checks, &Bitmap[0]);
+            }
+        }
+        if (generates > 0)
+        {
+            crc16_ecc240_encode_many(&Staging[checks * n], n, n, generates);
+        }
+
+        int c = 0, g = 0;
+        for (size_t i = 0; i < Working.size(); ++i)
+        {
+            const BatchRequest& request = Working[i];
+            int result;
+
+            if (request.Generate)
+            {
+                const uint8_t* encoded = &Staging[(checks + g++) * n];
+                request.Frame[n - 2] = encoded[n - 2];
+                request.Frame[n - 1] = encoded[n - 1];
+                result = (encoded[n - 2] << 8) | encoded[n - 1];
+            }
+            else
+            {
+                const int index = c++;
+                const bool failed = ((Bitmap[index / 64] >> (index % 64)) & 1) != 0;
+
+                if (!failed)
+                {
+                    memcpy(request.Frame, &Staging[index * n], n);
+                }
+                result = failed ? -1 : 0;
+            }
+
+            request.Done(request.Context, result);
+        }
+
+        Working.clear();
+    }
+};
+
+
+} // namespace crc16ecc240
+
+struct crc16_ecc240_batcher_t
+{
+    crc16ecc240::Batcher* Impl;
+};
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// API
+
+extern "C" crc16_ecc240_batcher_t* crc16_ecc240_batcher_create(int totalBytes, int maxBatch, int maxDelayUsec)
+{
+    if (totalBytes < 4 || (totalBytes & 1) || totalBytes > CRC16_ECC240_MAX_CODEWORD_BYTES ||
+        maxBatch < 1 || maxDelayUsec < 0)
+    {
+        return nullptr;
+    }
+
+    crc16_ecc240_batcher_t* batcher = new (std::nothrow) crc16_ecc240_batcher_t;
+    if (!batcher)
+    {
+        return nullptr;
+    }
+
+    // The constructor allocates buffers and starts a thread, either of
+    // which can throw, and exceptions must not cross the C API
+    try
+    {
+        batcher->Impl = new Batcher(totalBytes, maxBatch, maxDelayUsec);
+    }
+    catch (...)
+    {
+        delete batcher;
+        batcher = nullptr;
+    }
+    return batcher;
+}
+
+extern "C" void crc16_ecc240_batcher_destroy(crc16_ecc240_batcher_t* batcher)
+{
+    if (batcher)
+    {
+        delete batcher->Impl;
+        delete batcher;
+    }
+}
+
+extern "C" int crc16_ecc240_batcher_check(crc16_ecc240_batcher_t* batcher, uint8_t* frame,
+                                          crc16_ecc240_batcher_done_t done, void* context)
+{
+    return batcher->Impl->Submit(frame, done, context, false);
+}
+
+extern "C" int crc16_ecc240_batcher_generate(crc16_ecc240_batcher_t* batcher, uint8_t* frame,
+                                             crc16_ecc240_batcher_done_t done, void* context)
+{
+    return batcher->Impl->Submit(frame, done, context, true);
+}
+
+
+} // namespace crc16ecc240
@@ -0,0 +1,175 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_BATCHER_h
+#define CRC16_ECC240_BATCHER_h
+
+#include "crc16_ecc240.h"
+
+/*
+    Micro-batching front end for callers that each have only a few frames.
+
+    Connection handlers that check a frame at a time never fill the batch
+    kernels.  A batcher collects their requests from any number of threads
+    into one queue, and a flusher thread runs them through
+    crc16_ecc240_verify_many() / crc16_ecc240_correct_many() and
+    crc16_ecc240_encode_many() together.  A batch is flushed as soon as it
+    holds 'maxBatch' requests, or when its oldest request has waited
+    'maxDelayUsec', so the latency added to any one request is bounded.
+
+    Completion callbacks run on the flusher thread, so they should be short:
+    Hand the result to the caller's own thread or executor.
+
+    With C++20 coroutines, crc16ecc240::AsyncCheck() and AsyncGenerate()
+    return awaitables that submit the request and resume the coroutine with
+    its result.  The coroutine resumes on the flusher thread.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// API
+
+typedef struct crc16_ecc240_batcher_t crc16_ecc240_batcher_t;
+
+// Called once per request with its result, on the flusher thread
+typedef void (*crc16_ecc240_batcher_done_t)(void* context, int result);
+
+// Create a batcher for codewords of 'totalBytes' and start its thread.
+//
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+// Precondition: maxBatch >= 1; maxDelayUsec >= 0
+//
+// Returns NULL on failure.
+crc16_ecc240_batcher_t* crc16_ecc240_batcher_create(int totalBytes, int maxBatch, int maxDelayUsec);
+
+// Complete every queued request, stop the thread and free the batcher.
+// No other thread may submit once this has been called.
+void crc16_ecc240_batcher_destroy(crc16_ecc240_batcher_t* batcher);
+
+// Queue a check of a codeword, as crc16_ecc240_check_codeword() would do.
+// The frame is corrected in place and must stay valid until 'done' is
+// called with 0 on success or -1 if the frame could not be corrected.
+//
+// Returns 0 if queued, or -1 if the batcher is shutting down or out of memory.
+int crc16_ecc240_batcher_check(crc16_ecc240_batcher_t* batcher, uint8_t* frame,
+                               crc16_ecc240_batcher_done_t done, void* context);
+
+// Queue encoding of a codeword, as crc16_ecc240_encode_codeword() would do.
+// The CRC is written into the last two bytes of the frame, which must stay
+// valid until 'done' is called with the CRC.
+//
+// Returns 0 if queued, or -1 if the batcher is shutting down or out of memory.
+int crc16_ecc240_batcher_generate(crc16_ecc240_batcher_t* batcher, uint8_t* frame,
+                                  crc16_ecc240_batcher_done_t done, void* context);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Coroutine Awaitables
+
+#if defined(__cplusplus) && defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+
+namespace crc16ecc240 {
+
+/*
+    Awaitable for one batcher request:
+
+        int result = co_await crc16ecc240::AsyncCheck(batcher, frame);
+
+    The request is queued when the coroutine suspends.  If it cannot be
+    queued the coroutine does not suspend and the result is -1.
+*/
+class BatcherAwaitable
+{
+public:
+    typedef int (*Submit)(crc16_ecc240_batcher_t*, uint8_t*, crc16_ecc240_batcher_done_t, void*);
+
+    BatcherAwaitable(crc16_ecc240_batcher_t* batcher, uint8_t* frame, Submit submit)
+        : Batcher(batcher)
+        , Frame(frame)
+        , SubmitFunction(submit)
+        , Result(-1)
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) noexcept
+    {
+        Handle = handle;
+
+        // The flusher may resume the coroutine before this returns, so
+        // nothing here may touch the awaitable after a successful submit
+        return 0 == SubmitFunction(Batcher, Frame, &OnDone, this);
+    }
+
+    int await_resume() const noexcept { return Result; }
+
+private:
+    crc16_ecc240_batcher_t* Batcher;
+    uint8_t* Frame;
+    Submit SubmitFunction;
+    std::coroutine_handle<> Handle;
+    int Result;
+
+    static void OnDone(void* context, int result)
+    {
+        BatcherAwaitable* self = static_cast<BatcherAwaitable*>(context);
+        self->Result = result;
+        self->Handle.resume();
+    }
+};
+
+// co_await to check and correct a codeword; yields 0 on success or -1
+inline BatcherAwaitable AsyncCheck(crc16_ecc240_batcher_t* batcher, uint8_t* frame)
+{
+    return BatcherAwaitable(batcher, frame, &crc16_ecc240_batcher_check);
+}
+
+// co_await to encode a codeword; yields the CRC written into it
+inline BatcherAwaitable AsyncGenerate(crc16_ecc240_batcher_t* batcher, uint8_t* frame)
+{
+    return BatcherAwaitable(batcher, frame, &crc16_ecc240_batcher_generate);
+}
+
+} // namespace crc16ecc240
+
+#endif // __cpp_impl_coroutine
+
+
+#endif // CRC16_ECC240_BATCHER_h
@@ -0,0 +1,464 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_channel.h"
+
+#include <math.h>
+#include <string.h>
+#include <new>
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// Random Numbers
+
+// Independent generators stepped together
+static const int kLanes = 4;
+
+// Outputs generated per refill
+static const int kRandomBufferCount = 256;
+
+static uint64_t SplitMix64(uint64_t& x)
+{
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/*
+    xorshift128+ in kLanes independent lanes.
+
+    The lanes have no dependency on each other, so the inner loop of Refill()
+    is plain SIMD arithmetic once vectorized, and a whole buffer of outputs
+    costs a few cycles each.
+*/
+struct LaneRandom
+{
+    uint64_t S0[kLanes];
+    uint64_t S1[kLanes];
+    uint64_t Buffer[kRandomBufferCount];
+    int Used;
+
+    void Seed(uint64_t seed)
+    {
+        for (int k = 0; k < kLanes; ++k)
+        {
+            S0[k] = SplitMix64(seed);
+            S1[k] = SplitMix64(seed);
+        }
+        Used = kRandomBufferCount;
+    }
+
+    void Refill()
+    {
+        for (int i = 0; i < kRandomBufferCount; i += kLanes)
+        {
+            for (int k = 0; k < kLanes; ++k)
+            {
+                uint64_t s1 = S0[k];
+                const uint64_t s0 = S1[k];
+                S0[k] = s0;
+                s1 ^= s1 << 23;
+                S1[k] = s1 ^ s0 ^ (s1 >> 17) ^ (s0 >> 26);
+                Buffer[i + k] = S1[k] + s0;
+            }
+        }
+        Used = 0;
+    }
+
+    uint64_t Next()
+    {
+        if (Used >= kRandomBufferCount)
+        {
+            Refill();
+        }
+        return Buffer[Used++];
+    }
+
+    // Uniform on (0, 1], so its log is finite
+    double Uniform()
+    {
+        return (double)((Next() >> 11) + 1) * (1. / 9007199254740992.);
+    }
+};
+
+
+//-----------------------------------------------------------------------------
+// Geometric Skips
+
+// Stream position that is never reached
+static const uint64_t kNever = ~(uint64_t)0;
+
+static uint64_t SaturatingAdd(uint64_t a, uint64_t b)
+{
+    return (b >= kNever - a) ? kNever : a + b;
+}
+
+// Number of failures before the first success, for success probability p
+struct GeometricSkip
+{
+    double InvLog;
+    bool Never;
+    bool Always;
+
+    void Init(double p)
+    {
+        Never = !(p > 0.);
+        Always = (p >= 1.);
+        InvLog = (Never || Always) ? 0. : 1. / log1p(-p);
+    }
+
+    uint64_t Draw(LaneRandom& random) const
+    {
+        if (Never)
+        {
+            return kNever;
+        }
+        if (Always)
+        {
+            return 0;
+        }
+
+        const double skip = floor(log(random.Uniform()) * InvLog);
+        return (skip >= 1e18) ? kNever : (uint64_t)skip;
+    }
+};
+
+static bool IsProbability(double p)
+{
+    return p >= 0. && p <= 1.; // False for NaN
+}
+
+// Flip bit 'offset' of a buffer, MSB-first
+static CRC16_ECC240_FORCE_INLINE void FlipBit(uint8_t* data, uint64_t offset)
+{
+    data[offset >> 3] ^= (uint8_t)(0x80 >> (offset & 7));
+}
+
+enum ChannelModel
+{
+    // Binary-symmetric is a Gilbert-Elliott channel that never leaves Good
+    ChannelModel_Gilbert,
+    ChannelModel_Burst
+};
+
+
+} // namespace crc16ecc240
+
+struct crc16_ecc240_channel_t
+{
+    crc16ecc240::ChannelModel Model;
+    crc16ecc240::LaneRandom Random;
+
+    // Stream bits passed through so far
+    uint64_t Position;
+
+    // Stream position of the next bit error, or of the next burst start
+    uint64_t NextEvent;
+
+    // Gilbert-Elliott: Current state, where it ends, and skips per state
+    int Bad;
+    uint64_t StateEnd;
+    crc16ecc240::GeometricSkip ErrorSkip[2];
+    crc16ecc240::GeometricSkip LeaveSkip[2];
+
+    // Burst: Skip between bursts, and the burst in progress
+    crc16ecc240::GeometricSkip BurstSkip;
+    int BurstBits;
+    uint64_t BurstStart;
+    uint64_t BurstEnd;
+    uint64_t BurstCursor;
+
+    // Random bits for the inside of bursts
+    uint64_t Bits;
+    int BitsLeft;
+};
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// Models
+
+static uint64_t ApplyGilbert(crc16_ecc240_channel_t* ch, uint8_t* data, uint64_t end)
+{
+    uint64_t flips = 0;
+
+    for (;;)
+    {
+        if (ch->NextEvent < ch->StateEnd)
+        {
+            if (ch->NextEvent >= end)
+            {
+                break;
+            }
+
+            FlipBit(data, ch->NextEvent - ch->Position);
+            ++flips;
+            ch->NextEvent = SaturatingAdd(ch->NextEvent + 1, ch->ErrorSkip[ch->Bad].Draw(ch->Random));
+        }
+        else
+        {
+            if (ch->StateEnd >= end)
+            {
+                break;
+            }
+
+            // Both skips are memoryless, so redraw the next error from here
+            ch->Bad ^= 1;
+            ch->NextEvent = SaturatingAdd(ch->StateEnd, ch->ErrorSkip[ch->Bad].Draw(ch->Random));
+            ch->StateEnd = SaturatingAdd(ch->StateEnd + 1, ch->LeaveSkip[ch->Bad].Draw(ch->Random));
+        }
+    }
+
+    return flips;
+}
+
+static uint64_t ApplyBurst(crc16_ecc240_channel_t* ch, uint8_t* data, uint64_t end)
+{
+    uint64_t flips = 0;
+
+    for (;;)
+    {
+        if (ch->BurstCursor < ch->BurstEnd)
+        {
+            const uint64_t stop = (ch->BurstEnd < end) ? ch->BurstEnd : end;
+
+            for (; ch->BurstCursor < stop; ++ch->BurstCursor)
+            {
+                bool flip;
+                if (ch->BurstCursor == ch->BurstStart || ch->BurstCursor == ch->BurstEnd - 1)
+                {
+                    flip = true;
+                }
+                else
+                {
+                    if (ch->BitsLeft <= 0)
+                    {
+                        ch->Bits = ch->Random.Next();
+                        ch->BitsLeft = 64;
+                    }
+                    flip = (ch->Bits & 1) != 0;
+                    ch->Bits >>= 1;
+                    --ch->BitsLeft;
+                }
+
+                if (flip)
+                {
+                    FlipBit(data, ch->BurstCursor - ch->Position);
+                    ++flips;
+                }
+            }
+
+            if (ch->BurstCursor < ch->BurstEnd)
+            {
+                break; // Continues in the next buffer
+            }
+
+            ch->NextEvent = SaturatingAdd(ch->BurstEnd, ch->BurstSkip.Draw(ch->Random));
+        }
+
+        if (ch->NextEvent >= end)
+        {
+            break;
+        }
+
+        ch->BurstStart = ch->NextEvent;
+        ch->BurstEnd = SaturatingAdd(ch->BurstStart, (uint64_t)ch->BurstBits);
+        ch->BurstCursor = ch->BurstStart;
+    }
+
+    return flips;
+}
+
+
+//-----------------------------------------------------------------------------
+// API
+
+static crc16_ecc240_channel_t* NewChannel(ChannelModel model, uint64_t seed)
+{
+    crc16_ecc240_channel_t* ch = new (std::nothrow) crc16_ecc240_channel_t;
+    if (ch)
+    {
+        ch->Model = model;
+        ch->Random.Seed(seed);
+        ch->Position = 0;
+        ch->NextEvent = kNever;
+        ch->Bad = 0;
+        ch->StateEnd = kNever;
+        ch->ErrorSkip[0].Init(0.);
+        ch->ErrorSkip[1].Init(0.);
+        ch->LeaveSkip[0].Init(0.);
+        ch->LeaveSkip[1].Init(0.);
+        ch->BurstSkip.Init(0.);
+        ch->BurstBits = 0;
+        ch->BurstStart = 0;
+        ch->BurstEnd = 0;
+        ch->BurstCursor = 0;
+        ch->Bits = 0;
+        ch->BitsLeft = 0;
+    }
+    return ch;
+}
+
+extern "C" crc16_ecc240_channel_t* crc16_ecc240_channel_bsc(double ber, uint64_t seed)
+{
+    return crc16_ecc240_channel_gilbert(0., 0., ber, 0., seed);
+}
+
+extern "C" crc16_ecc240_channel_t* crc16_ecc240_channel_gilbert(double goodToBad, double badToGood,
+                                                                double berGood, double berBad, uint64_t seed)
+{
+    if (!IsProbability(goodToBad) || !IsProbability(badToGood) ||
+        !IsProbability(berGood) || !IsProbability(berBad))
+    {
+        return nullptr;
+    }
+
+    crc16_ecc240_channel_t* ch = NewChannel(ChannelModel_Gilbert, seed);
+    if (ch)
+    {
+        ch->ErrorSkip[0].Init(berGood);
+        ch->ErrorSkip[1].Init(berBad);
+        ch->LeaveSkip[0].Init(goodToBad);
+        ch->LeaveSkip[1].Init(badToGood);
+        ch->NextEvent = ch->ErrorSkip[0].Draw(ch->Random);
+        ch->StateEnd = SaturatingAdd(1, ch->LeaveSkip[0].Draw(ch->Random));
+    }
+    return ch;
+}
+
+extern "C" crc16_ecc240_channel_t* crc16_ecc240_channel_burst(double burstRate, int burstBits, uint64_t seed)
+{
+    if (!IsProbability(burstRate) || burstBits < 1)
+    {
+        return nullptr;
+    }
+
+    crc16_ecc240_channel_t* ch = NewChannel(ChannelModel_Burst, seed);
+    if (ch)
+    {
+        ch->BurstSkip.Init(burstRate);
+        ch->BurstBits = burstBits;
+        ch->NextEvent = ch->BurstSkip.Draw(ch->Random);
+    }
+    return ch;
+}
+
+extern "C" void crc16_ecc240_channel_destroy(crc16_ecc240_channel_t* channel)
+{
+    delete channel;
+}
+
+extern "C" uint64_t crc16_ecc240_channel_apply(crc16_ecc240_channel_t* channel, uint8_t* data, size_t bytes)
+{
+    const uint64_t end = channel->Position + (uint64_t)bytes * 8;
+
+    uint64_t flips;
+    if (channel->Model == ChannelModel_Burst)
+    {
+        flips = ApplyBurst(channel, data, end);
+    }
+    else
+    {
+        flips = ApplyGilbert(channel, data, end);
+    }
+
+    channel->Position = end;
+    return flips;
+}
+
+
+//-----------------------------------------------------------------------------
+// Evaluation
+
+// Frames sent through the channel per call
+static const int kEvaluateBatch = 256;
+
+extern "C" void crc16_ecc240_channel_evaluate(crc16_ecc240_channel_t* channel, int frameBytes, uint64_t frames,
+                                              crc16_ecc240_trace_decoder_t decoder, void* context,
+                                              crc16_ecc240_trace_counts_t* counts)
+{
+    uint8_t sent[kEvaluateBatch * CRC16_ECC240_MAX_CODEWORD_BYTES];
+    uint8_t received[kEvaluateBatch * CRC16_ECC240_MAX_CODEWORD_BYTES];
+
+    while (frames > 0)
+    {
+        const int count = (frames < (uint64_t)kEvaluateBatch) ? (int)frames : kEvaluateBatch;
+        const size_t batchBytes = (size_t)count * frameBytes;
+
+        // The buffers have room for a partial last word
+        for (size_t i = 0; i < batchBytes; i += 8)
+        {
+            const uint64_t r = channel->Random.Next();
+            memcpy(sent + i, &r, 8);
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            crc16_ecc240_encode_codeword(sent + i * frameBytes, frameBytes);
+        }
+
+        // Frames go back to back, so bursts can straddle them
+        memcpy(received, sent, batchBytes);
+        crc16_ecc240_channel_apply(channel, received, batchBytes);
+
+        for (int i = 0; i < count; ++i)
+        {
+            uint8_t* frame = received + i * frameBytes;
+            const uint8_t* original = sent + i * frameBytes;
+            const bool damaged = (0 != memcmp(frame, original, frameBytes));
+
+            const int result = decoder ? decoder(context, frame, frameBytes)
+                                       : crc16_ecc240_check_codeword(frame, frameBytes);
+
+            if (result != 0)
+            {
+                ++counts->Rejected;
+            }
+            else if (0 != memcmp(frame, original, frameBytes))
+            {
+                ++counts->Miscorrected;
+            }
+            else if (!damaged)
+            {
+                ++counts->Clean;
+            }
+            else
+            {
+                ++counts->Corrected;
+            }
+        }
+
+        frames -= count;
+    }
+}
+
+
+} // namespace crc16ecc240
@@ -0,0 +1,115 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_CHANNEL_h
+#define CRC16_ECC240_CHANNEL_h
+
+#include "crc16_ecc240_trace.h"
+
+/*
+    Simulated bit-error channels for evaluating decoders at scale.
+
+    Models:
+
+        Binary-symmetric:  Each bit flips independently with probability p.
+
+        Gilbert-Elliott:  A two-state Markov chain, Good and Bad, with its own
+        bit error rate in each state, so errors arrive in clusters.
+
+        Fixed burst:  Bursts of exactly 'burstBits' start at random with the
+        given rate per bit.  The first and last bits of a burst are flipped
+        and the bits between flip with probability 1/2.
+
+    A channel treats everything passed to it as one continuous bit stream,
+    so state and bursts carry over from one buffer to the next.  Bits are
+    numbered MSB-first within each byte, matching transmission order.
+
+    Rather than drawing one random number per bit, the distance to the next
+    event is drawn from a geometric distribution, so a 10^-6 channel costs
+    about one draw per million bits.  Uniform values come from several
+    independent xorshift128+ lanes stepped together, which the compiler turns
+    into SIMD code.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// API
+
+typedef struct crc16_ecc240_channel_t crc16_ecc240_channel_t;
+
+// Binary-symmetric channel with bit error rate 'ber'.
+//
+// Returns NULL on failure.
+crc16_ecc240_channel_t* crc16_ecc240_channel_bsc(double ber, uint64_t seed);
+
+// Gilbert-Elliott channel.  Per bit, the chain moves from Good to Bad with
+// probability 'goodToBad' and back with probability 'badToGood'.
+// The chain starts in the Good state.
+//
+// Returns NULL on failure.
+crc16_ecc240_channel_t* crc16_ecc240_channel_gilbert(double goodToBad, double badToGood,
+                                                     double berGood, double berBad, uint64_t seed);
+
+// Fixed-length bursts of 'burstBits' starting with probability 'burstRate'
+// per bit.  Bursts do not overlap.
+//
+// Returns NULL on failure.
+crc16_ecc240_channel_t* crc16_ecc240_channel_burst(double burstRate, int burstBits, uint64_t seed);
+
+// Free a channel
+void crc16_ecc240_channel_destroy(crc16_ecc240_channel_t* channel);
+
+// Pass the next 'bytes' of the stream through the channel, flipping bits
+// in place.
+//
+// Returns the number of bits flipped.
+uint64_t crc16_ecc240_channel_apply(crc16_ecc240_channel_t* channel, uint8_t* data, size_t bytes);
+
+// Encode 'frames' random codewords of 'frameBytes' each, send them back to
+// back through the channel, run each through a decoder and tally outcomes
+// into 'counts'.
+//
+// 'decoder' may be NULL to use crc16_ecc240_check_codeword().  It is only
+// called from this thread.
+//
+// Precondition: frameBytes >= 4; frameBytes is even; frameBytes <= 32
+void crc16_ecc240_channel_evaluate(crc16_ecc240_channel_t* channel, int frameBytes, uint64_t frames,
+                                   crc16_ecc240_trace_decoder_t decoder, void* context,
+                                   crc16_ecc240_trace_counts_t* counts);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // CRC16_ECC240_CHANNEL_h
@@ -0,0 +1,263 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_dual.h"
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// Tables
+
+// Columns: 32 CRC bits then every data bit, by distance from the end
+static const int kMaxColumns = 32 + CRC16_ECC240_DUAL_MAX_DATA_BYTES * 8;
+static const int kHashSlots = 8192;
+
+// Multiply a 16-bit remainder by x^-1 modulo a polynomial with constant term
+static uint16_t DivX(uint16_t v, uint32_t poly)
+{
+    return (uint16_t)((v & 1) ? ((v ^ poly) >> 1) : (v >> 1));
+}
+
+struct DualTables
+{
+    // Reduction modulo P * Q for a 16-bit word: xx00 << 16 and 00yy << 16
+    uint32_t Crc[2][256];
+
+    // Split a 32-bit remainder modulo P * Q into the two CRC16s, per byte
+    uint32_t Split[4][256];
+
+    // Syndrome of a single flipped bit, by column
+    uint32_t Column[kMaxColumns];
+
+    // Open-addressed hash of syndrome -> column, with 0 marking empty slots
+    // (single-bit syndromes are never zero)
+    uint32_t HashKey[kHashSlots];
+    uint16_t HashColumn[kHashSlots];
+
+    DualTables()
+    {
+        // Carry-less product P * Q, with the x^32 term implied
+        uint64_t g = 0;
+        for (int i = 0; i <= 16; ++i)
+        {
+            if (CRC16_ECC240_DUAL_POLY >> i & 1)
+            {
+                g ^= (uint64_t)CRC16_ECC240_POLY << i;
+            }
+        }
+        const uint32_t poly = (uint32_t)g;
+
+        for (int k = 0; k < 2; ++k)
+        {
+            for (uint32_t b = 0; b < 256; ++b)
+            {
+                uint32_t r = b << 24;
+                for (int i = 0; i < 8 * (1 + k); ++i)
+                {
+                    r = (r << 1) ^ ((r & 0x80000000) ? poly : 0);
+                }
+                Crc[k][b] = r;
+            }
+        }
+
+        /*
+            The remainder R = M x^32 mod PQ, so R mod P = CRC_P x^16 and
+            CRC_P = (R mod P) x^-16.  Map each bit of R, then fill the byte
+            tables by linearity.
+        */
+        uint32_t bitImage[32];
+        for (int i = 0; i < 32; ++i)
+        {
+            // x^i reduced modulo each polynomial
+            uint32_t rp = 1, rq = 1;
+            for (int j = 0; j < i; ++j)
+            {
+                rp <<= 1;
+                if (rp & 0x10000) rp ^= CRC16_ECC240_POLY;
+                rq <<= 1;
+                if (rq & 0x10000) rq ^= CRC16_ECC240_DUAL_POLY;
+            }
+            for (int j = 0; j < 16; ++j)
+            {
+                rp = DivX((uint16_t)rp, CRC16_ECC240_POLY);
+                rq = DivX((uint16_t)rq, CRC16_ECC240_DUAL_POLY);
+            }
+            bitImage[i] = (rp << 16) | rq;
+        }
+        for (int k = 0; k < 4; ++k)
+        {
+            for (int b = 0; b < 256; ++b)
+            {
+                uint32_t v = 0;
+                for (int i = 0; i < 8; ++i)
+                {
+                    if (b >> i & 1)
+                    {
+                        v ^= bitImage[8 * k + i];
+                    }
+                }
+                Split[k][b] = v;
+            }
+        }
+
+        // A flipped CRC bit flips the same bit of the syndrome
+        for (int i = 0; i < 32; ++i)
+        {
+            Column[i] = (uint32_t)1 << i;
+        }
+
+        // A data bit k places from the end leaves x^(k+16) modulo each
+        uint32_t sp = 0x5935, sq = 1;
+        for (int j = 0; j < 16; ++j)
+        {
+            sq <<= 1;
+            if (sq & 0x10000) sq ^= CRC16_ECC240_DUAL_POLY;
+        }
+        for (int i = 32; i < kMaxColumns; ++i)
+        {
+            Column[i] = (sp << 16) | sq;
+            sp <<= 1;
+            if (sp & 0x10000) sp ^= CRC16_ECC240_POLY;
+            sq <<= 1;
+            if (sq & 0x10000) sq ^= CRC16_ECC240_DUAL_POLY;
+        }
+
+        for (int i = 0; i < kHashSlots; ++i)
+        {
+            HashKey[i] = 0;
+        }
+        for (int i = 0; i < kMaxColumns; ++i)
+        {
+            int slot = Hash(Column[i]);
+            while (HashKey[slot] != 0)
+            {
+                slot = (slot + 1) & (kHashSlots - 1);
+            }
+            HashKey[slot] = Column[i];
+            HashColumn[slot] = (uint16_t)i;
+        }
+    }
+
+    static CRC16_ECC240_FORCE_INLINE int Hash(uint32_t v)
+    {
+        return (int)((v * 2654435761u) >> 19) & (kHashSlots - 1);
+    }
+
+    // Returns the column with this single-bit syndrome, or -1
+    CRC16_ECC240_FORCE_INLINE int Find(uint32_t syndrome) const
+    {
+        for (int slot = Hash(syndrome); HashKey[slot] != 0; slot = (slot + 1) & (kHashSlots - 1))
+        {
+            if (HashKey[slot] == syndrome)
+            {
+                return HashColumn[slot];
+            }
+        }
+        return -1;
+    }
+};
+
+static const DualTables Dual;
+
+
+//-----------------------------------------------------------------------------
+// crc16_ecc240_dual_generate
+
+extern "C" uint32_t crc16_ecc240_dual_generate(const void* vdata, int bytes)
+{
+    const uint8_t * CRC16_ECC240_RESTRICT data = reinterpret_cast<const uint8_t * CRC16_ECC240_RESTRICT>(vdata);
+    uint32_t r = 0;
+
+    for (int i = 0; i < bytes; i += 2)
+    {
+        // Convert data into a 16-bit word
+        uint32_t w = (uint32_t)data[i + 1] | ((uint32_t)data[i] << 8);
+
+        uint32_t a = (r >> 16) ^ w;
+        r = (r << 16) ^ Dual.Crc[1][a >> 8] ^ Dual.Crc[0][a & 0xff];
+    }
+
+    return Dual.Split[0][r & 0xff] ^ Dual.Split[1][(r >> 8) & 0xff] ^
+           Dual.Split[2][(r >> 16) & 0xff] ^ Dual.Split[3][r >> 24];
+}
+
+
+//-----------------------------------------------------------------------------
+// crc16_ecc240_dual_check
+
+// Flip the bit for a column, unless it lies in the CRC field
+static void FlipColumn(uint8_t* data, int bytes, int column)
+{
+    if (column >= 32)
+    {
+        const int bitPosition = bytes * 8 - 1 - (column - 32);
+        data[bitPosition / 8] ^= (uint8_t)(0x80 >> (bitPosition % 8));
+    }
+}
+
+extern "C" int crc16_ecc240_dual_check(uint8_t* data, int bytes, uint32_t receivedCRC)
+{
+    const uint32_t syndrome = crc16_ecc240_dual_generate(data, bytes) ^ receivedCRC;
+    if (syndrome == 0)
+    {
+        // Already fine
+        return 0;
+    }
+
+    const int columns = 32 + bytes * 8;
+
+    // Single bit error
+    int single = Dual.Find(syndrome);
+    if (single >= 0)
+    {
+        if (single >= columns)
+        {
+            return -1;
+        }
+        FlipColumn(data, bytes, single);
+        return 0;
+    }
+
+    // Two bit errors: Try each first bit and look up the second
+    for (int i = 0; i < columns; ++i)
+    {
+        int j = Dual.Find(syndrome ^ Dual.Column[i]);
+        if (j > i && j < columns)
+        {
+            FlipColumn(data, bytes, i);
+            FlipColumn(data, bytes, j);
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+
+} // namespace crc16ecc240
@@ -0,0 +1,93 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_DUAL_h
+#define CRC16_ECC240_DUAL_h
+
+#include "crc16_ecc240.h"
+
+/*
+    Dual-polynomial 32-bit check mode.
+
+    A frame carries two CRC16s: One over CRC16_ECC240_POLY and one over
+    CRC16_ECC240_DUAL_POLY.  The polynomials are coprime, so together the
+    two remainders identify the remainder modulo their product, and the pair
+    acts as a 32-bit code with HD=5 for frames up to 532 data bytes.  That is
+    enough to correct any two flipped bits, where the single CRC16 corrects
+    one bit in 30 bytes.
+
+    Both CRCs are produced in one pass: The data is reduced modulo the 32-bit
+    product P * Q like a CRC-32, and the two CRC16s are read off the final
+    remainder through one packed table.
+
+    Two-bit errors are located in O(n): For each candidate first bit, the
+    remaining syndrome is looked up in a hash of all single-bit syndromes.
+
+    The second polynomial was chosen by exhaustive search over all 16-bit
+    polynomials for the longest HD=5 length of the combined code.
+*/
+
+// Koopman 0xf4cb = x^16 +x^15 +x^14 +x^13 +x^11 +x^8 +x^7 +x^4 +x^2 +x +1
+#define CRC16_ECC240_DUAL_POLY 0x1e997
+
+// Most data bytes for which any two bit errors are corrected
+#define CRC16_ECC240_DUAL_MAX_DATA_BYTES 532
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// API
+
+// Compute both CRC16s of the data in one pass.
+//
+// Precondition: bytes is even
+//
+// Returns the CRC over CRC16_ECC240_POLY in the high 16 bits and the CRC over
+// CRC16_ECC240_DUAL_POLY in the low 16 bits.  Send it big-endian after the
+// data.
+uint32_t crc16_ecc240_dual_generate(const void* data, int bytes);
+
+// Check the data against the received CRCs and correct up to two bit errors.
+// May modify the data to correct errors.
+//
+// Precondition: bytes is even; bytes <= CRC16_ECC240_DUAL_MAX_DATA_BYTES
+//
+// Returns 0 on success.
+// Returns non-zero on failure to correct the data.
+int crc16_ecc240_dual_check(uint8_t* data, int bytes, uint32_t receivedCRC);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // CRC16_ECC240_DUAL_h
@@ -0,0 +1,255 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_interleave.h"
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// 8x8 bit-matrix transpose
+
+/*
+    Transpose an 8x8 bit matrix held with row 0 in the most significant byte
+    and column 0 in the most significant bit of each byte.
+    From "Hacker's Delight" by Henry S. Warren, section 7-3.
+*/
+static CRC16_ECC240_FORCE_INLINE uint64_t Transpose8(uint64_t x)
+{
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    return x;
+}
+
+// Interleave frames 8 at a time
+static void InterleaveScalar(const uint8_t* frames, int frameBytes, int depth, uint8_t* wire)
+{
+    const int stride = depth / 8; // Wire bytes between successive frame bits
+
+    for (int g = 0; g < stride; ++g)
+    {
+        const uint8_t* group = frames + g * 8 * frameBytes;
+
+        for (int k = 0; k < frameBytes; ++k)
+        {
+            uint64_t x = 0;
+            for (int r = 0; r < 8; ++r)
+            {
+                x = (x << 8) | group[r * frameBytes + k];
+            }
+
+            x = Transpose8(x);
+
+            // Row j holds bit j of byte k from each of the 8 frames
+            uint8_t* out = wire + 8 * k * stride + g;
+            for (int j = 0; j < 8; ++j)
+            {
+                out[j * stride] = (uint8_t)(x >> (56 - 8 * j));
+            }
+        }
+    }
+}
+
+static void DeinterleaveScalar(const uint8_t* wire, int frameBytes, int depth, uint8_t* frames)
+{
+    const int stride = depth / 8;
+
+    for (int g = 0; g < stride; ++g)
+    {
+        uint8_t* group = frames + g * 8 * frameBytes;
+
+        for (int k = 0; k < frameBytes; ++k)
+        {
+            const uint8_t* in = wire + 8 * k * stride + g;
+            uint64_t x = 0;
+            for (int j = 0; j < 8; ++j)
+            {
+                x = (x << 8) | in[j * stride];
+            }
+
+            x = Transpose8(x);
+
+            for (int r = 0; r < 8; ++r)
+            {
+                group[r * frameBytes + k] = (uint8_t)(x >> (56 - 8 * r));
+            }
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// SSE2 16-frame transpose
+
+#ifdef CRC16_ECC240_TARGET_SSE2
+
+/*
+    Vector lane r holds frame kLaneFrame[r] of a group of 16.
+    Reversing each half means that _mm_movemask_epi8() puts frame 0 in the
+    most significant bit of the first wire byte, matching the bit order of
+    the frames.
+*/
+static const int kLaneFrame[16] = { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 };
+
+// Transpose a 16x16 byte matrix with four rounds of the perfect shuffle
+CRC16_ECC240_TARGET_SSE2 static void Transpose16(__m128i v[16])
+{
+    for (int round = 0; round < 4; ++round)
+    {
+        __m128i w[16];
+        for (int i = 0; i < 8; ++i)
+        {
+            w[2 * i] = _mm_unpacklo_epi8(v[i], v[i + 8]);
+            w[2 * i + 1] = _mm_unpackhi_epi8(v[i], v[i + 8]);
+        }
+        for (int i = 0; i < 16; ++i)
+        {
+            v[i] = w[i];
+        }
+    }
+}
+
+CRC16_ECC240_TARGET_SSE2 static void InterleaveSSE2(const uint8_t* frames, int frameBytes, int depth, uint8_t* wire)
+{
+    const int stride = depth / 8;
+
+    for (int g = 0; g < depth / 16; ++g)
+    {
+        const uint8_t* group = frames + g * 16 * frameBytes;
+
+        for (int c = 0; c < frameBytes; c += 16)
+        {
+            __m128i v[16];
+            for (int r = 0; r < 16; ++r)
+            {
+                v[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group + kLaneFrame[r] * frameBytes + c));
+            }
+
+            // v[k] now holds byte c+k of each frame
+            Transpose16(v);
+
+            for (int k = 0; k < 16; ++k)
+            {
+                __m128i x = v[k];
+                uint8_t* out = wire + 8 * (c + k) * stride + 2 * g;
+
+                for (int b = 0; b < 8; ++b, out += stride)
+                {
+                    const int mask = _mm_movemask_epi8(x);
+                    out[0] = (uint8_t)mask;
+                    out[1] = (uint8_t)(mask >> 8);
+
+                    // Next bit into the sign position
+                    x = _mm_add_epi8(x, x);
+                }
+            }
+        }
+    }
+}
+
+CRC16_ECC240_TARGET_SSE2 static void DeinterleaveSSE2(const uint8_t* wire, int frameBytes, int depth, uint8_t* frames)
+{
+    const int stride = depth / 8;
+    const __m128i laneBits = _mm_set_epi8(
+        (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+        (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    const __m128i one = _mm_set1_epi8(1);
+    const uint64_t kSplat = 0x0101010101010101ULL;
+
+    for (int g = 0; g < depth / 16; ++g)
+    {
+        uint8_t* group = frames + g * 16 * frameBytes;
+
+        for (int c = 0; c < frameBytes; c += 16)
+        {
+            __m128i v[16];
+
+            for (int k = 0; k < 16; ++k)
+            {
+                const uint8_t* in = wire + 8 * (c + k) * stride + 2 * g;
+                __m128i acc = _mm_setzero_si128();
+
+                for (int b = 0; b < 8; ++b, in += stride)
+                {
+                    // Spread bit r of the 16 wire bits into lane r
+                    __m128i x = _mm_set_epi64x((long long)(in[1] * kSplat), (long long)(in[0] * kSplat));
+                    x = _mm_cmpeq_epi8(_mm_and_si128(x, laneBits), laneBits);
+
+                    acc = _mm_or_si128(_mm_add_epi8(acc, acc), _mm_and_si128(x, one));
+                }
+
+                v[k] = acc;
+            }
+
+            Transpose16(v);
+
+            for (int r = 0; r < 16; ++r)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(group + kLaneFrame[r] * frameBytes + c), v[r]);
+            }
+        }
+    }
+}
+
+#endif // CRC16_ECC240_TARGET_SSE2
+
+
+//-----------------------------------------------------------------------------
+// API
+
+extern "C" void crc16_ecc240_interleave(const uint8_t* frames, int frameBytes, int depth, uint8_t* wire)
+{
+#ifdef CRC16_ECC240_TARGET_SSE2
+    if (depth % 16 == 0 && frameBytes % 16 == 0)
+    {
+        InterleaveSSE2(frames, frameBytes, depth, wire);
+        return;
+    }
+#endif
+    InterleaveScalar(frames, frameBytes, depth, wire);
+}
+
+extern "C" void crc16_ecc240_deinterleave(const uint8_t* wire, int frameBytes, int depth, uint8_t* frames)
+{
+#ifdef CRC16_ECC240_TARGET_SSE2
+    if (depth % 16 == 0 && frameBytes % 16 == 0)
+    {
+        DeinterleaveSSE2(wire, frameBytes, depth, frames);
+        return;
+    }
+#endif
+    DeinterleaveScalar(wire, frameBytes, depth, frames);
+}
+
+
+} // namespace crc16ecc240
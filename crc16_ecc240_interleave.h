@@ -0,0 +1,79 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_INTERLEAVE_h
+#define CRC16_ECC240_INTERLEAVE_h
+
+#include "crc16_ecc240.h"
+
+/*
+    Bit interleaving across frames.
+
+    crc16_ecc240_check() corrects one flipped bit per frame, but many channels
+    flip runs of bits.  Interleaving 'depth' frames sends bit j of every frame
+    before bit j+1 of any frame:
+
+        wire bit t  =  bit (t / depth) of frame (t % depth)
+
+    so a burst of up to 'depth' consecutive wire bits lands as at most one
+    flipped bit in each frame, which the single-bit decoder then fixes.
+
+    Bits are numbered in transmission order, most significant bit of each byte
+    first, for both the frames and the wire.
+
+    The transpose runs 16 frames at a time through SSE2 byte-matrix transposes
+    and movemask, and falls back to 8x8 bit-matrix transposes in 64-bit words.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// API
+
+// Interleave 'depth' frames that are stored back to back in 'frames'.
+//
+// Precondition: depth is a multiple of 8
+// Precondition: wire has room for depth * frameBytes bytes
+void crc16_ecc240_interleave(const uint8_t* frames, int frameBytes, int depth, uint8_t* wire);
+
+// Undo crc16_ecc240_interleave().
+//
+// Precondition: depth is a multiple of 8
+// Precondition: frames has room for depth * frameBytes bytes
+void crc16_ecc240_deinterleave(const uint8_t* wire, int frameBytes, int depth, uint8_t* frames);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // CRC16_ECC240_INTERLEAVE_h
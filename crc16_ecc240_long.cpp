@@ -0,0 +1,214 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_long.h"
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// GF(2)[x] / CRC16_ECC240_LONG_POLY
+
+// Multiply by x modulo the polynomial
+static CRC16_ECC240_FORCE_INLINE uint16_t LongMulX(uint16_t a)
+{
+    return (uint16_t)((a << 1) ^ ((a & 0x8000) ? (CRC16_ECC240_LONG_POLY & 0xffff) : 0));
+}
+
+// Multiply a by b modulo the polynomial, one bit at a time
+static uint16_t LongMul(uint16_t a, uint16_t b)
+{
+    uint16_t r = 0;
+    for (int i = 15; i >= 0; --i)
+    {
+        r = LongMulX(r);
+        if (b >> i & 1)
+        {
+            r ^= a;
+        }
+    }
+    return r;
+}
+
+// Baby steps x^j for j < kBabySteps, and giant steps of x^-kBabySteps
+static const int kBabySteps = 256;
+static const int kGiantSteps = 256;
+static const int kHashSlots = 512;
+
+struct LongTables
+{
+    // Byte-at-a-time CRC table
+    uint16_t Crc[256];
+
+    // Open-addressed hash of x^j -> j, with 0xffff marking empty slots
+    // (x^j is never zero)
+    uint16_t BabyValue[kHashSlots];
+    uint16_t BabyExponent[kHashSlots];
+
+    // Multiply by x^-kBabySteps, split into low and high byte tables
+    uint16_t GiantLo[256];
+    uint16_t GiantHi[256];
+
+    LongTables()
+    {
+        for (int b = 0; b < 256; ++b)
+        {
+            uint16_t r = (uint16_t)(b << 8);
+            for (int i = 0; i < 8; ++i)
+            {
+                r = LongMulX(r);
+            }
+            Crc[b] = r;
+        }
+
+        for (int i = 0; i < kHashSlots; ++i)
+        {
+            BabyValue[i] = 0xffff;
+        }
+        uint16_t xj = 1;
+        for (int j = 0; j < kBabySteps; ++j)
+        {
+            int slot = Hash(xj);
+            while (BabyValue[slot] != 0xffff)
+            {
+                slot = (slot + 1) & (kHashSlots - 1);
+            }
+            BabyValue[slot] = xj;
+            BabyExponent[slot] = (uint16_t)j;
+            xj = LongMulX(xj);
+        }
+
+        // x^-256 = x^(65535 - 256)
+        uint16_t g = 1;
+        for (int i = 0; i < 65535 - kBabySteps; ++i)
+        {
+            g = LongMulX(g);
+        }
+        uint16_t g8 = g;
+        for (int i = 0; i < 8; ++i)
+        {
+            g8 = LongMulX(g8);
+        }
+        for (int b = 0; b < 256; ++b)
+        {
+            GiantLo[b] = LongMul((uint16_t)b, g);
+            GiantHi[b] = LongMul((uint16_t)b, g8);
+        }
+    }
+
+    static CRC16_ECC240_FORCE_INLINE int Hash(uint16_t v)
+    {
+        return (int)((v * 40503u) >> 7) & (kHashSlots - 1);
+    }
+
+    // Returns j with x^j = v for j < kBabySteps, or -1
+    int FindBaby(uint16_t v) const
+    {
+        for (int slot = Hash(v); BabyValue[slot] != 0xffff; slot = (slot + 1) & (kHashSlots - 1))
+        {
+            if (BabyValue[slot] == v)
+            {
+                return BabyExponent[slot];
+            }
+        }
+        return -1;
+    }
+
+    /*
+        Returns d with x^d = syndrome, 0 <= d < 65535.
+
+        Writing d = i * 256 + j, syndrome * x^(-256 i) = x^j, so each giant
+        step is one table multiply and one hash probe.
+    */
+    int Log(uint16_t syndrome) const
+    {
+        uint16_t y = syndrome;
+        for (int i = 0; i < kGiantSteps; ++i)
+        {
+            int j = FindBaby(y);
+            if (j >= 0)
+            {
+                return i * kBabySteps + j;
+            }
+            y = GiantLo[y & 0xff] ^ GiantHi[y >> 8];
+        }
+        return -1; // Only for syndrome == 0
+    }
+};
+
+static const LongTables Long;
+
+
+//-----------------------------------------------------------------------------
+// crc16_ecc240_long_generate
+
+extern "C" uint16_t crc16_ecc240_long_generate(const void* vdata, int bytes)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(vdata);
+
+    uint16_t crc = 0;
+    for (int i = 0; i < bytes; ++i)
+    {
+        crc = (uint16_t)(crc << 8) ^ Long.Crc[(crc >> 8) ^ data[i]];
+    }
+    return crc;
+}
+
+
+//-----------------------------------------------------------------------------
+// crc16_ecc240_long_check
+
+extern "C" int crc16_ecc240_long_check(uint8_t* data, int bytes, uint16_t receivedCRC)
+{
+    const uint16_t syndrome = crc16_ecc240_long_generate(data, bytes) ^ receivedCRC;
+    if (syndrome == 0)
+    {
+        // Already fine
+        return 0;
+    }
+
+    // Distance of the flipped bit from the end of the CRC
+    const int distance = Long.Log(syndrome);
+    if (distance < 0 || distance >= (bytes + 2) * 8)
+    {
+        // Not a single bit error within this frame
+        return -1;
+    }
+
+    // An error in the CRC field leaves the data intact
+    if (distance >= 16)
+    {
+        const int bitPosition = (bytes + 2) * 8 - 1 - distance;
+        data[bitPosition / 8] ^= 1 << (distance % 8);
+    }
+
+    return 0;
+}
+
+
+} // namespace crc16ecc240
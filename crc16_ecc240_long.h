@@ -0,0 +1,91 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_LONG_h
+#define CRC16_ECC240_LONG_h
+
+#include "crc16_ecc240.h"
+
+/*
+    Single-bit correction for long frames.
+
+    crc16_ecc240_check() locates an error by stepping the syndrome backwards
+    one bit at a time, which is fine for 240 bits.  For longer frames the bit
+    position is the discrete logarithm of the syndrome: A single error 'd'
+    bits from the end of the codeword leaves the syndrome x^d mod P.
+
+    CRC16_ECC240_POLY cannot be used for this: x has order 257 modulo that
+    polynomial, so syndromes repeat every 257 bits.  Long frames instead use
+    a primitive polynomial, where x has the full order 65535 and every bit of
+    a codeword up to 65535 bits long has a distinct syndrome (HD=3).
+
+    The logarithm is found by baby-step giant-step with 256 steps of each,
+    using about 3 KB of tables that stay resident in L1 cache.
+
+    Note that HD=3 leaves no margin: Two bit errors are usually "corrected"
+    into a third wrong bit, so pair this with an outer check or a reliable
+    channel.  The short-frame decoder keeps its HD=5 detection.
+*/
+
+// x^16 + x^5 + x^3 + x^2 + 1, primitive
+#define CRC16_ECC240_LONG_POLY 0x1002D
+
+// Most data bytes for which single-bit errors are uniquely located
+#define CRC16_ECC240_LONG_MAX_DATA_BYTES (65535 / 8 - 2)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// API
+
+// Compute the CRC16 of the data using CRC16_ECC240_LONG_POLY.
+//
+// Precondition: data points to a valid buffer that is 'bytes' in length
+//
+// Returns the calculated CRC
+uint16_t crc16_ecc240_long_generate(const void* data, int bytes);
+
+// Check the data against the received CRC and correct one bit error.
+// May modify the data to correct errors.
+//
+// Precondition: bytes <= CRC16_ECC240_LONG_MAX_DATA_BYTES
+//
+// Returns 0 on success.
+// Returns non-zero on failure to correct the data.
+int crc16_ecc240_long_check(uint8_t* data, int bytes, uint16_t receivedCRC);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // CRC16_ECC240_LONG_h
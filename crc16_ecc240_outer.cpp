@@ -0,0 +1,362 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_outer.h"
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// GF(2^8)
+
+// x^8 + x^4 + x^3 + x^2 + 1, the usual Reed-Solomon field polynomial
+static const unsigned GF_POLY = 0x11D;
+
+struct GaloisField
+{
+    uint8_t Exp[512];
+    uint8_t Log[256];
+
+    // Products of each constant with every low and high nibble
+    CRC16_ECC240_ALIGNED uint8_t MulLo[256][16];
+    CRC16_ECC240_ALIGNED uint8_t MulHi[256][16];
+
+    // Parity row i, data column j
+    uint8_t Matrix[CRC16_ECC240_OUTER_MAX_PARITY][CRC16_ECC240_OUTER_MAX_DATA];
+
+    GaloisField()
+    {
+        unsigned x = 1;
+        for (int i = 0; i < 255; ++i)
+        {
+            Exp[i] = (uint8_t)x;
+            Log[x] = (uint8_t)i;
+            x <<= 1;
+            if (x & 0x100)
+            {
+                x ^= GF_POLY;
+            }
+        }
+        for (int i = 255; i < 512; ++i)
+        {
+            Exp[i] = Exp[i - 255];
+        }
+        Log[0] = 0;
+
+        for (int c = 0; c < 256; ++c)
+        {
+            for (int n = 0; n < 16; ++n)
+            {
+                MulLo[c][n] = Mul((uint8_t)c, (uint8_t)n);
+                MulHi[c][n] = Mul((uint8_t)c, (uint8_t)(n << 4));
+            }
+        }
+
+        /*
+            Cauchy matrix 1 / (x_i + y_j) with x_i = i and y_j = MAX_PARITY + j,
+            so every square submatrix is invertible.  Dividing each column by
+            its row 0 entry keeps that property and turns row 0 into all ones.
+            The entries do not depend on the group shape, so a group may drop
+            trailing parity frames without re-encoding.
+        */
+        for (int j = 0; j < CRC16_ECC240_OUTER_MAX_DATA; ++j)
+        {
+            const uint8_t y = (uint8_t)(CRC16_ECC240_OUTER_MAX_PARITY + j);
+            for (int i = 0; i < CRC16_ECC240_OUTER_MAX_PARITY; ++i)
+            {
+                Matrix[i][j] = Div(y, (uint8_t)(i ^ y));
+            }
+        }
+    }
+
+    uint8_t Mul(uint8_t a, uint8_t b) const
+    {
+        if (a == 0 || b == 0)
+        {
+            return 0;
+        }
+        return Exp[Log[a] + Log[b]];
+    }
+
+    // Precondition: b != 0
+    uint8_t Div(uint8_t a, uint8_t b) const
+    {
+        if (a == 0)
+        {
+            return 0;
+        }
+        return Exp[Log[a] + 255 - Log[b]];
+    }
+};
+
+static const GaloisField GF;
+
+
+//-----------------------------------------------------------------------------
+// Region multiply-add
+
+#ifdef CRC16_ECC240_TARGET_SSSE3
+
+// dst[] ^= c * src[] for whole 16-byte blocks; returns bytes processed
+CRC16_ECC240_TARGET_SSSE3 static int MulAddSSSE3(uint8_t* dst, const uint8_t* src, uint8_t c, int bytes)
+{
+    const __m128i lo = _mm_load_si128((const __m128i*)GF.MulLo[c]);
+    const __m128i hi = _mm_load_si128((const __m128i*)GF.MulHi[c]);
+    const __m128i mask = _mm_set1_epi8(0x0f);
+
+    int i = 0;
+    for (; i + 16 <= bytes; i += 16)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i l = _mm_shuffle_epi8(lo, _mm_and_si128(x, mask));
+        __m128i h = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi64(x, 4), mask));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(d, _mm_xor_si128(l, h)));
+    }
+    return i;
+}
+
+#endif // CRC16_ECC240_TARGET_SSSE3
+
+// dst[] ^= c * src[]
+static void MulAdd(uint8_t* CRC16_ECC240_RESTRICT dst, const uint8_t* CRC16_ECC240_RESTRICT src, uint8_t c, int bytes)
+{
+    if (c == 0)
+    {
+        return;
+    }
+    if (c == 1)
+    {
+        for (int i = 0; i < bytes; ++i)
+        {
+            dst[i] ^= src[i];
+        }
+        return;
+    }
+
+    int i = 0;
+#ifdef CRC16_ECC240_TARGET_SSSE3
+    if (CpuHasSSSE3())
+    {
+        i = MulAddSSSE3(dst, src, c, bytes);
+    }
+#endif
+
+    const uint8_t* lo = GF.MulLo[c];
+    const uint8_t* hi = GF.MulHi[c];
+    for (; i < bytes; ++i)
+    {
+        const uint8_t x = src[i];
+        dst[i] ^= lo[x & 15] ^ hi[x >> 4];
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Matrix inversion
+
+/*
+    Invert the n x n matrix 'a' into 'inv' by Gauss-Jordan elimination.
+    Returns false if the matrix is singular.
+*/
+static bool Invert(uint8_t a[][CRC16_ECC240_OUTER_MAX_PARITY], uint8_t inv[][CRC16_ECC240_OUTER_MAX_PARITY], int n)
+{
+    for (int r = 0; r < n; ++r)
+    {
+        for (int c = 0; c < n; ++c)
+        {
+            inv[r][c] = (r == c) ? 1 : 0;
+        }
+    }
+
+    for (int col = 0; col < n; ++col)
+    {
+        int pivot = col;
+        while (pivot < n && a[pivot][col] == 0)
+        {
+            ++pivot;
+        }
+        if (pivot >= n)
+        {
+            return false;
+        }
+        if (pivot != col)
+        {
+            for (int c = 0; c < n; ++c)
+            {
+                uint8_t t = a[col][c]; a[col][c] = a[pivot][c]; a[pivot][c] = t;
+                t = inv[col][c]; inv[col][c] = inv[pivot][c]; inv[pivot][c] = t;
+            }
+        }
+
+        const uint8_t scale = GF.Div(1, a[col][col]);
+        for (int c = 0; c < n; ++c)
+        {
+            a[col][c] = GF.Mul(a[col][c], scale);
+            inv[col][c] = GF.Mul(inv[col][c], scale);
+        }
+
+        for (int r = 0; r < n; ++r)
+        {
+            const uint8_t f = a[r][col];
+            if (r == col || f == 0)
+            {
+                continue;
+            }
+            for (int c = 0; c < n; ++c)
+            {
+                a[r][c] ^= GF.Mul(f, a[col][c]);
+                inv[r][c] ^= GF.Mul(f, inv[col][c]);
+            }
+        }
+    }
+
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// crc16_ecc240_outer_encode
+
+extern "C" void crc16_ecc240_outer_encode(const uint8_t* data, int dataCount, uint8_t* parity, int parityCount, int totalBytes)
+{
+    const int payloadBytes = totalBytes - 2;
+
+    for (int i = 0; i < parityCount; ++i)
+    {
+        uint8_t* out = parity + i * totalBytes;
+        memset(out, 0, payloadBytes);
+
+        for (int j = 0; j < dataCount; ++j)
+        {
+            MulAdd(out, data + j * totalBytes, GF.Matrix[i][j], payloadBytes);
+        }
+
+        crc16_ecc240_encode_codeword(out, totalBytes);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// crc16_ecc240_outer_decode
+
+extern "C" int crc16_ecc240_outer_decode(uint8_t* data, int dataCount, uint8_t* parity, int parityCount, int totalBytes)
+{
+    const int payloadBytes = totalBytes - 2;
+
+    int erased[CRC16_ECC240_OUTER_MAX_PARITY];
+    int erasedCount = 0;
+
+    for (int j = 0; j < dataCount; ++j)
+    {
+        if (crc16_ecc240_check_codeword(data + j * totalBytes, totalBytes) != 0)
+        {
+            if (erasedCount >= parityCount)
+            {
+                return -1;
+            }
+            erased[erasedCount++] = j;
+        }
+    }
+
+    if (erasedCount == 0)
+    {
+        return 0;
+    }
+
+    // Pick the first valid parity rows, one per erasure
+    int rows[CRC16_ECC240_OUTER_MAX_PARITY];
+    int rowCount = 0;
+
+    for (int i = 0; i < parityCount && rowCount < erasedCount; ++i)
+    {
+        if (crc16_ecc240_check_codeword(parity + i * totalBytes, totalBytes) == 0)
+        {
+            rows[rowCount++] = i;
+        }
+    }
+
+    if (rowCount < erasedCount)
+    {
+        return -1;
+    }
+
+    // Remove the surviving data frames from each parity row
+    uint8_t residual[CRC16_ECC240_OUTER_MAX_PARITY][CRC16_ECC240_MAX_CODEWORD_BYTES];
+
+    for (int r = 0; r < rowCount; ++r)
+    {
+        const int i = rows[r];
+        memcpy(residual[r], parity + i * totalBytes, payloadBytes);
+
+        for (int j = 0, e = 0; j < dataCount; ++j)
+        {
+            if (e < erasedCount && erased[e] == j)
+            {
+                ++e;
+                continue;
+            }
+            MulAdd(residual[r], data + j * totalBytes, GF.Matrix[i][j], payloadBytes);
+        }
+    }
+
+    // Solve for the erased frames
+    uint8_t a[CRC16_ECC240_OUTER_MAX_PARITY][CRC16_ECC240_OUTER_MAX_PARITY];
+    uint8_t inv[CRC16_ECC240_OUTER_MAX_PARITY][CRC16_ECC240_OUTER_MAX_PARITY];
+
+    for (int r = 0; r < rowCount; ++r)
+    {
+        for (int e = 0; e < erasedCount; ++e)
+        {
+            a[r][e] = GF.Matrix[rows[r]][erased[e]];
+        }
+    }
+
+    if (!Invert(a, inv, erasedCount))
+    {
+        return -1;
+    }
+
+    for (int e = 0; e < erasedCount; ++e)
+    {
+        uint8_t* out = data + erased[e] * totalBytes;
+        memset(out, 0, payloadBytes);
+
+        for (int r = 0; r < rowCount; ++r)
+        {
+            MulAdd(out, residual[r], inv[e][r], payloadBytes);
+        }
+
+        crc16_ecc240_encode_codeword(out, totalBytes);
+    }
+
+    return erasedCount;
+}
+
+
+} // namespace crc16ecc240
@@ -0,0 +1,95 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_OUTER_h
+#define CRC16_ECC240_OUTER_h
+
+#include "crc16_ecc240.h"
+
+/*
+    Outer erasure code across frames.
+
+    A frame that crc16_ecc240_check_codeword() cannot correct would normally
+    be retransmitted.  Instead a group of K data codewords can be sent with M
+    extra parity codewords, and any M frames of the group that fail their CRC
+    are rebuilt locally from the rest.  On long links this is far cheaper than
+    a round trip.
+
+    The parity is a systematic Reed-Solomon style code over GF(2^8) built from
+    a Cauchy matrix, scaled so that the first parity frame is the plain XOR of
+    the data frames.  Each parity frame carries its own CRC, so the CRC marks
+    which frames are erasures and the outer code never has to locate errors.
+
+    Multiplication runs 16 bytes at a time through SSSE3 nibble tables, with a
+    table-driven scalar fallback.
+*/
+
+// Most parity frames per group
+#define CRC16_ECC240_OUTER_MAX_PARITY 16
+
+// Most data frames per group
+#define CRC16_ECC240_OUTER_MAX_DATA (256 - CRC16_ECC240_OUTER_MAX_PARITY)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// API
+
+// Compute 'parityCount' parity codewords over 'dataCount' data codewords.
+//
+// The data frames are stored back to back in 'data' and must already be
+// encoded.  The parity frames are written back to back to 'parity' and are
+// encoded codewords of the same size.
+//
+// Precondition: 1 <= dataCount <= CRC16_ECC240_OUTER_MAX_DATA
+// Precondition: 1 <= parityCount <= CRC16_ECC240_OUTER_MAX_PARITY
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+void crc16_ecc240_outer_encode(const uint8_t* data, int dataCount, uint8_t* parity, int parityCount, int totalBytes);
+
+// Check every frame of a group, correcting single-bit errors in place, and
+// rebuild data frames that fail their CRC from the parity frames.
+//
+// Lost frames may be passed in with any contents; they will fail the CRC.
+//
+// Precondition: The same counts and totalBytes as crc16_ecc240_outer_encode()
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+//
+// Returns the number of data frames rebuilt.
+// Returns -1 if more data frames failed than there are valid parity frames.
+int crc16_ecc240_outer_decode(uint8_t* data, int dataCount, uint8_t* parity, int parityCount, int totalBytes);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // CRC16_ECC240_OUTER_h
@@ -0,0 +1,372 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_parallel.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// WorkerPool
+
+/*
+    Persistent pool of worker threads.
+
+    Each Run() publishes one task and bumps the generation number.  Workers
+    sleep on a condition variable until the generation changes, run their
+    slice of the task, and the last one to finish wakes the caller.
+*/
+class WorkerPool
+{
+public:
+    WorkerPool()
+        : Task(nullptr)
+        , Generation(0)
+        , Remaining(0)
+        , WorkerCount(1)
+        , Terminating(false)
+        , Started(false)
+    {
+    }
+    ~WorkerPool() { Stop(); }
+
+    bool IsStarted() const { return Started; }
+
+    void Start(int threads)
+    {
+        if (threads <= 0)
+        {
+            threads = (int)std::thread::hardware_concurrency();
+            if (threads <= 0) threads = 1;
+        }
+
+        Terminating = false;
+        Started = true;
+        WorkerCount = threads;
+
+        // Generation keeps counting across restarts, so new workers must
+        // start from its current value rather than treat it as new work
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> locker(Lock);
+            generation = Generation;
+        }
+
+        // The caller is worker 0
+        for (int i = 1; i < threads; ++i)
+        {
+            Threads.push_back(std::thread(&WorkerPool::Loop, this, i, generation));
+        }
+    }
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> locker(Lock);
+            Terminating = true;
+        }
+        WorkAvailable.notify_all();
+
+        for (size_t i = 0; i < Threads.size(); ++i)
+        {
+            Threads[i].join();
+        }
+        Threads.clear();
+        Started = false;
+    }
+
+    int GetWorkerCount() const { return WorkerCount; }
+
+    void Run(const std::function<void(int, int)>& task)
+    {
+        std::lock_guard<std::mutex> runLocker(RunLock);
+
+        {
+            std::lock_guard<std::mutex> locker(Lock);
+            Task = &task;
+            Remaining = WorkerCount - 1;
+            ++Generation;
+        }
+        WorkAvailable.notify_all();
+
+        task(0, WorkerCount);
+
+        std::unique_lock<std::mutex> locker(Lock);
+        while (Remaining > 0)
+        {
+            WorkDone.wait(locker);
+        }
+        Task = nullptr;
+    }
+
+private:
+    std::vector<std::thread> Threads;
+    std::mutex RunLock;
+    std::mutex Lock;
+    std::condition_variable WorkAvailable;
+    std::condition_variable WorkDone;
+    const std::function<void(int, int)>* Task;
+    uint64_t Generation;
+    int Remaining;
+    int WorkerCount;
+    bool Terminating;
+    bool Started;
+
+    void Loop(int index, uint64_t seen)
+    {
+        for (;;)
+        {
+            const std::function<void(int, int)>* task;
+            {
+                std::unique_lock<std::mutex> locker(Lock);
+                while (!Terminating && Generation == seen)
+                {
+                    WorkAvailable.wait(locker);
+                }
+                if (Terminating)
+                {
+                    return;
+                }
+                seen = Generation;
+                task = Task;
+            }
+
+            (*task)(index, WorkerCount);
+
+            bool last;
+            {
+                std::lock_guard<std::mutex> locker(Lock);
+                last = (--Remaining == 0);
+            }
+            if (last)
+            {
+                WorkDone.notify_one();
+            }
+        }
+    }
+};
+
+static std::mutex PoolLock;
+static WorkerPool Pool;
+
+static WorkerPool& GetPool()
+{
+    std::lock_guard<std::mutex> locker(PoolLock);
+    if (!Pool.IsStarted())
+    {
+        Pool.Start(0);
+    }
+    return Pool;
+}
+
+void ParallelRun(const std::function<void(int, int)>& task)
+{
+    GetPool().Run(task);
+}
+
+int ParallelWorkerCount()
+{
+    return GetPool().GetWorkerCount();
+}
+
+void ParallelSlice(size_t count, int parts, int index, size_t granularity,
+                   size_t& begin, size_t& end)
+{
+    size_t per = (count + parts - 1) / parts;
+    per = (per + granularity - 1) / granularity * granularity;
+
+    begin = per * index;
+    end = begin + per;
+    if (begin > count) begin = count;
+    if (end > count) end = count;
+}
+
+
+//-----------------------------------------------------------------------------
+// API
+
+// Below this many frames the wake-up latency of the pool exceeds the work
+static const size_t kMinParallelFrames = 4096;
+
+// Frames checked per call to crc16_ecc240_verify_many() within a slice
+static const size_t kBatchFrames = 4096;
+
+// Below this many bytes a buffer is hashed on the calling thread
+static const size_t kMinParallelBytes = 256 * 1024;
+
+// Bytes hashed per call to crc16_ecc240_generate(), which takes an int length
+static const size_t kChunkBytes = 1 << 20;
+
+extern "C" int crc16_ecc240_parallel_init(int threads)
+{
+    std::lock_guard<std::mutex> locker(PoolLock);
+    if (Pool.IsStarted())
+    {
+        return -1;
+    }
+    Pool.Start(threads);
+    return 0;
+}
+
+extern "C" void crc16_ecc240_parallel_shutdown()
+{
+    std::lock_guard<std::mutex> locker(PoolLock);
+    Pool.Stop();
+}
+
+static void EncodeSlice(uint8_t* frames, int totalBytes, size_t stride, size_t begin, size_t end)
+{
+    crc16_ecc240_encode_many(frames + begin * stride, totalBytes, stride, end - begin);
+}
+
+static void CheckSlice(uint8_t* frames, int totalBytes, size_t stride, size_t begin, size_t end,
+                       crc16_ecc240_counts_t& counts, uint64_t* bitmap)
+{
+    uint64_t localBitmap[kBatchFrames / 64];
+
+    for (size_t i = begin; i < end; i += kBatchFrames)
+    {
+        int count = (int)((end - i < kBatchFrames) ? (end - i) : kBatchFrames);
+        uint8_t* batch = frames + i * stride;
+
+        // Slices start on multiples of 64 frames, so words are not shared
+        uint64_t* words = bitmap ? bitmap + i / 64 : localBitmap;
+
+        int flagged = crc16_ecc240_verify_many(batch, totalBytes, stride, count, words);
+        int failed = flagged ? crc16_ecc240_correct_many(batch, totalBytes, stride, count, words) : 0;
+
+        counts.Clean += count - flagged;
+        counts.Corrected += flagged - failed;
+        counts.Failed += failed;
+    }
+}
+
+extern "C" void crc16_ecc240_encode_parallel(uint8_t* frames, int totalBytes, size_t stride, size_t count)
+{
+    if (count < kMinParallelFrames)
+    {
+        EncodeSlice(frames, totalBytes, stride, 0, count);
+        return;
+    }
+
+    ParallelRun([&](int index, int workers) {
+        size_t begin, end;
+        ParallelSlice(count, workers, index, 64, begin, end);
+        EncodeSlice(frames, totalBytes, stride, begin, end);
+    });
+}
+
+extern "C" void crc16_ecc240_check_parallel(uint8_t* frames, int totalBytes, size_t stride, size_t count,
+                                            crc16_ecc240_counts_t* counts, uint64_t* bitmap)
+{
+    memset(counts, 0, sizeof(crc16_ecc240_counts_t));
+
+    if (count < kMinParallelFrames)
+    {
+        CheckSlice(frames, totalBytes, stride, 0, count, *counts, bitmap);
+        return;
+    }
+
+    // One cache line of counts per worker to avoid false sharing
+    struct PaddedCounts
+    {
+        crc16_ecc240_counts_t Counts;
+        uint8_t Padding[CRC16_ECC240_CACHE_LINE_BYTES];
+    };
+    std::vector<PaddedCounts> perWorker(ParallelWorkerCount());
+
+    ParallelRun([&](int index, int workers) {
+        crc16_ecc240_counts_t& local = perWorker[index].Counts;
+        memset(&local, 0, sizeof(local));
+
+        size_t begin, end;
+        ParallelSlice(count, workers, index, 64, begin, end);
+        CheckSlice(frames, totalBytes, stride, begin, end, local, bitmap);
+    });
+
+    for (size_t i = 0; i < perWorker.size(); ++i)
+    {
+        counts->Clean += perWorker[i].Counts.Clean;
+        counts->Corrected += perWorker[i].Counts.Corrected;
+        counts->Failed += perWorker[i].Counts.Failed;
+    }
+}
+
+
+static uint16_t GenerateSlice(const uint8_t* data, size_t bytes)
+{
+    uint16_t crc = 0;
+    for (size_t i = 0; i < bytes; i += kChunkBytes)
+    {
+        size_t chunk = (bytes - i < kChunkBytes) ? (bytes - i) : kChunkBytes;
+        crc = crc16_ecc240_combine(crc, crc16_ecc240_generate(data + i, (int)chunk), chunk);
+    }
+    return crc;
+}
+
+extern "C" uint16_t crc16_ecc240_generate_parallel(const void* vdata, size_t bytes)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(vdata);
+
+    if (bytes < kMinParallelBytes)
+    {
+        return GenerateSlice(data, bytes);
+    }
+
+    // One cache line per worker to avoid false sharing
+    struct PaddedCRC
+    {
+        uint16_t CRC;
+        size_t Bytes;
+        uint8_t Padding[CRC16_ECC240_CACHE_LINE_BYTES];
+    };
+    std::vector<PaddedCRC> perWorker(ParallelWorkerCount());
+
+    ParallelRun([&](int index, int workers) {
+        // Slice in 16-bit words so every slice has an even length
+        size_t begin, end;
+        ParallelSlice(bytes / 2, workers, index, 1, begin, end);
+        perWorker[index].CRC = GenerateSlice(data + begin * 2, (end - begin) * 2);
+        perWorker[index].Bytes = (end - begin) * 2;
+    });
+
+    uint16_t crc = 0;
+    for (size_t i = 0; i < perWorker.size(); ++i)
+    {
+        crc = crc16_ecc240_combine(crc, perWorker[i].CRC, perWorker[i].Bytes);
+    }
+    return crc;
+}
+
+
+} // namespace crc16ecc240
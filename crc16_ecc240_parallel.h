@@ -0,0 +1,141 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_PARALLEL_h
+#define CRC16_ECC240_PARALLEL_h
+
+#include "crc16_ecc240.h"
+
+#include <stddef.h> // size_t
+
+/*
+    Multi-core bulk processing for large arrays of codewords.
+
+    A pool of worker threads is started once and reused for every call, so
+    short jobs do not pay for thread creation.  The calling thread takes part
+    in the work as well, and jobs too small to be worth waking the workers are
+    run on the calling thread alone.
+
+    The frame array is split statically: worker k always gets the k-th slice
+    of the array.  When the frames are first written by
+    crc16_ecc240_encode_parallel(), the operating system places each slice on
+    the NUMA node of the worker that touched it, and later checks of the same
+    array find their slice in local memory.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// API
+
+typedef struct crc16_ecc240_counts_t
+{
+    // Frames that arrived without errors
+    uint64_t Clean;
+
+    // Frames that had an error corrected
+    uint64_t Corrected;
+
+    // Frames that could not be corrected
+    uint64_t Failed;
+} crc16_ecc240_counts_t;
+
+// Start the worker pool.
+// 'threads' is the total number of threads including the caller; 0 selects
+// the number of hardware threads.  Calling this is optional: The pool is
+// started with the default on first use.
+//
+// Returns 0 on success.
+// Returns non-zero if the pool was already started.
+int crc16_ecc240_parallel_init(int threads);
+
+// Stop the worker pool and join its threads.
+// Precondition: No parallel calls are in progress.
+void crc16_ecc240_parallel_shutdown();
+
+// Append the CRC to each frame with crc16_ecc240_encode_codeword().
+//
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+// Precondition: stride >= totalBytes
+void crc16_ecc240_encode_parallel(uint8_t* frames, int totalBytes, size_t stride, size_t count);
+
+// Check and correct each frame, as crc16_ecc240_check_codeword() would.
+//
+// 'counts' receives the totals across all frames.
+// 'bitmap' may be NULL.  Otherwise it receives one bit per frame that could
+// not be corrected, laid out as for crc16_ecc240_verify_many().
+//
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+// Precondition: stride >= totalBytes
+void crc16_ecc240_check_parallel(uint8_t* frames, int totalBytes, size_t stride, size_t count,
+                                 crc16_ecc240_counts_t* counts, uint64_t* bitmap);
+
+
+// Compute the CRC16 of a large buffer, as crc16_ecc240_generate() would.
+// Each worker hashes one slice and the slice CRCs are merged with
+// crc16_ecc240_combine(), so the result is identical to the serial path.
+//
+// Precondition: bytes is even
+//
+// Returns the calculated CRC
+uint16_t crc16_ecc240_generate_parallel(const void* data, size_t bytes);
+
+#ifdef __cplusplus
+}
+
+#include <functional>
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// C++ Tools
+
+// Run task(workerIndex, workerCount) once on every thread of the shared pool,
+// with workerIndex 0 on the calling thread.  Returns when all have finished.
+// Calls from several threads at once are serialized.
+void ParallelRun(const std::function<void(int, int)>& task);
+
+// Number of threads that ParallelRun() will use, including the caller
+int ParallelWorkerCount();
+
+// Split 'count' items into 'parts' slices whose boundaries are multiples of
+// 'granularity', and return the bounds of slice 'index'
+void ParallelSlice(size_t count, int parts, int index, size_t granularity,
+                   size_t& begin, size_t& end);
+
+
+} // namespace crc16ecc240
+
+#endif // __cplusplus
+
+
+#endif // CRC16_ECC240_PARALLEL_h
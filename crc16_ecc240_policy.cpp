@@ -0,0 +1,359 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_policy.h"
+
+#include <atomic>
+#include <new>
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// Burst Syndromes
+
+enum SyndromeClass
+{
+    SyndromeClass_Clean,
+    SyndromeClass_Single,
+    SyndromeClass_Burst,
+    SyndromeClass_Other,
+
+    SyndromeClass_Count
+};
+
+/*
+    Classify the error in a codeword with the syndrome class table.  For
+    single and burst errors, 'entry' receives the position of the first
+    flipped bit << 8 | the burst pattern, with bit k of the pattern for the
+    bit k places after it: 1, 11, 101 or 111.
+*/
+static SyndromeClass Classify(const uint8_t* frame, int totalBytes, uint32_t& entry)
+{
+    const uint16_t residue = crc16_ecc240_generate(frame, totalBytes);
+    if (residue == 0)
+    {
+        return SyndromeClass_Clean;
+    }
+
+    int bitPosition;
+    uint32_t pattern;
+    switch (ClassifyResidue(residue, totalBytes * 8, bitPosition))
+    {
+    case CRC16_ECC240_CLASS_DATA_BIT:
+    case CRC16_ECC240_CLASS_CRC_BIT:
+        pattern = 1;
+        break;
+    case CRC16_ECC240_CLASS_ADJACENT:
+        pattern = 3;
+        break;
+    case CRC16_ECC240_CLASS_SPLIT:
+        pattern = 5;
+        break;
+    case CRC16_ECC240_CLASS_TRIPLE:
+        pattern = 7;
+        break;
+    default:
+        return SyndromeClass_Other;
+    }
+
+    entry = ((uint32_t)bitPosition << 8) | pattern;
+    return (pattern == 1) ? SyndromeClass_Single : SyndromeClass_Burst;
+}
+
+// Flip the bits of a burst found by Classify()
+static void FlipBurst(uint8_t* frame, uint32_t entry)
+{
+    const int first = (int)(entry >> 8);
+    const uint8_t pattern = (uint8_t)entry;
+
+    for (int k = 0; k < CRC16_ECC240_POLICY_MAX_BURST; ++k)
+    {
+        if (pattern & (1 << k))
+        {
+            const int bitPosition = first + k;
+            frame[bitPosition / 8] ^= (uint8_t)(0x80 >> (bitPosition % 8));
+        }
+    }
+}
+
+extern "C" int crc16_ecc240_check_burst(uint8_t* frame, int totalBytes)
+{
+    uint32_t entry;
+    switch (Classify(frame, totalBytes, entry))
+    {
+    case SyndromeClass_Clean:
+        return 0;
+    case SyndromeClass_Single:
+    case SyndromeClass_Burst:
+        FlipBurst(frame, entry);
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Counters
+
+enum PolicyCounter
+{
+    PolicyCounter_Frames,
+    PolicyCounter_Clean,
+    PolicyCounter_Single,
+    PolicyCounter_Burst,
+    PolicyCounter_Other,
+    PolicyCounter_Rejected,
+
+    PolicyCounter_Count
+};
+
+
+} // namespace crc16ecc240
+
+struct crc16_ecc240_policy_t
+{
+    // Read-only after creation
+    crc16_ecc240_policy_config_t Config;
+
+    // Read by the checking thread, written by updates
+    std::atomic<int> Mode;
+
+    // Written only by the checking thread.  Plain loads and stores rather
+    // than atomic increments, since there is a single writer.
+    uint8_t CounterPadding[CRC16_ECC240_CACHE_LINE_BYTES];
+    std::atomic<uint64_t> Counters[crc16ecc240::PolicyCounter_Count];
+    std::atomic<int> TotalBits;
+
+    // Update side: Counters at the last update, and decayed deltas
+    uint8_t UpdatePadding[CRC16_ECC240_CACHE_LINE_BYTES];
+    uint64_t LastCounters[crc16ecc240::PolicyCounter_Count];
+    double Decayed[crc16ecc240::PolicyCounter_Count];
+};
+
+namespace crc16ecc240 {
+
+static CRC16_ECC240_FORCE_INLINE void AddCounter(crc16_ecc240_policy_t* policy, int counter, uint64_t n)
+{
+    std::atomic<uint64_t>& c = policy->Counters[counter];
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// Whether a frame in this class is accepted in this mode
+static CRC16_ECC240_FORCE_INLINE bool Accepts(int mode, SyndromeClass sc)
+{
+    return sc == SyndromeClass_Clean ||
+           (sc == SyndromeClass_Single && mode != CRC16_ECC240_POLICY_DETECT) ||
+           (sc == SyndromeClass_Burst && mode == CRC16_ECC240_POLICY_BURST);
+}
+
+
+//-----------------------------------------------------------------------------
+// API
+
+extern "C" crc16_ecc240_policy_t* crc16_ecc240_policy_create(const crc16_ecc240_policy_config_t* config)
+{
+    crc16_ecc240_policy_t* policy = new (std::nothrow) crc16_ecc240_policy_t;
+    if (!policy)
+    {
+        return nullptr;
+    }
+
+    if (config)
+    {
+        policy->Config = *config;
+    }
+    else
+    {
+        policy->Config.MiscorrectionBudget = 1e-9;
+        policy->Config.MinFrames = 10000;
+        policy->Config.Decay = 0.5;
+        policy->Config.InitialMode = CRC16_ECC240_POLICY_SINGLE;
+    }
+
+    policy->Mode.store(policy->Config.InitialMode, std::memory_order_relaxed);
+    for (int i = 0; i < PolicyCounter_Count; ++i)
+    {
+        policy->Counters[i].store(0, std::memory_order_relaxed);
+        policy->LastCounters[i] = 0;
+        policy->Decayed[i] = 0.;
+    }
+    policy->TotalBits.store(CRC16_ECC240_MAX_CODEWORD_BYTES * 8, std::memory_order_relaxed);
+    return policy;
+}
+
+extern "C" void crc16_ecc240_policy_destroy(crc16_ecc240_policy_t* policy)
+{
+    delete policy;
+}
+
+extern "C" int crc16_ecc240_policy_check(crc16_ecc240_policy_t* policy, uint8_t* frame, int totalBytes)
+{
+    uint32_t entry;
+    const SyndromeClass sc = Classify(frame, totalBytes, entry);
+    const int mode = policy->Mode.load(std::memory_order_relaxed);
+
+    AddCounter(policy, PolicyCounter_Frames, 1);
+    AddCounter(policy, (int)PolicyCounter_Clean + (int)sc, 1);
+    policy->TotalBits.store(totalBytes * 8, std::memory_order_relaxed);
+
+    if (!Accepts(mode, sc))
+    {
+        AddCounter(policy, PolicyCounter_Rejected, 1);
+        return -1;
+    }
+
+    if (sc != SyndromeClass_Clean)
+    {
+        FlipBurst(frame, entry);
+    }
+    return 0;
+}
+
+extern "C" int crc16_ecc240_policy_check_many(crc16_ecc240_policy_t* policy, uint8_t* frames, int totalBytes,
+                                              size_t stride, int count, uint64_t* bitmap)
+{
+    const int mode = policy->Mode.load(std::memory_order_relaxed);
+
+    // Clean frames are only counted; the rest are classified one by one
+    const int flagged = crc16_ecc240_verify_many(frames, totalBytes, stride, count, bitmap);
+    uint64_t classCounts[SyndromeClass_Count] = { 0 };
+    int rejected = 0;
+
+    for (int i = 0; i < count && flagged > 0; i += 64)
+    {
+        uint64_t word = bitmap[i / 64];
+
+        for (uint64_t pending = word; pending; pending &= pending - 1)
+        {
+            int j = 0;
+            while (!((pending >> j) & 1))
+            {
+                ++j;
+            }
+
+            uint8_t* frame = frames + (size_t)(i + j) * stride;
+            uint32_t entry;
+            const SyndromeClass sc = Classify(frame, totalBytes, entry);
+            ++classCounts[sc];
+
+            if (Accepts(mode, sc))
+            {
+                if (sc != SyndromeClass_Clean)
+                {
+                    FlipBurst(frame, entry);
+                }
+                word ^= (uint64_t)1 << j;
+            }
+            else
+            {
+                ++rejected;
+            }
+        }
+
+        bitmap[i / 64] = word;
+    }
+
+    classCounts[SyndromeClass_Clean] += count - flagged;
+
+    AddCounter(policy, PolicyCounter_Frames, count);
+    for (int sc = 0; sc < SyndromeClass_Count; ++sc)
+    {
+        AddCounter(policy, (int)PolicyCounter_Clean + sc, classCounts[sc]);
+    }
+    AddCounter(policy, PolicyCounter_Rejected, rejected);
+    policy->TotalBits.store(totalBytes * 8, std::memory_order_relaxed);
+
+    return rejected;
+}
+
+extern "C" int crc16_ecc240_policy_update(crc16_ecc240_policy_t* policy)
+{
+    const crc16_ecc240_policy_config_t& config = policy->Config;
+
+    for (int i = 0; i < PolicyCounter_Count; ++i)
+    {
+        const uint64_t now = policy->Counters[i].load(std::memory_order_relaxed);
+        policy->Decayed[i] = policy->Decayed[i] * config.Decay + (double)(now - policy->LastCounters[i]);
+        policy->LastCounters[i] = now;
+    }
+
+    int mode = policy->Mode.load(std::memory_order_relaxed);
+    const double frames = policy->Decayed[PolicyCounter_Frames];
+    if (frames < (double)config.MinFrames || frames <= 0.)
+    {
+        return mode;
+    }
+
+    const double single = policy->Decayed[PolicyCounter_Single] / frames;
+    const double burst = policy->Decayed[PolicyCounter_Burst] / frames;
+    const double other = policy->Decayed[PolicyCounter_Other] / frames;
+
+    // Syndromes each mode claims in a codeword of n bits
+    const double n = (double)policy->TotalBits.load(std::memory_order_relaxed);
+    const double claimed[3] = { 0., n, 4. * n - 5. };
+    static const double kSyndromes = 65535.;
+
+    // Heavy errors that missed every burst syndrome show up as "other"
+    const double heavy = other / (1. - claimed[CRC16_ECC240_POLICY_BURST] / kSyndromes);
+
+    const double retransmits[3] = { single + burst + other, burst + other, other };
+
+    // Fewest retransmits within budget; ties keep the stronger detection
+    mode = CRC16_ECC240_POLICY_DETECT;
+    for (int m = CRC16_ECC240_POLICY_SINGLE; m <= CRC16_ECC240_POLICY_BURST; ++m)
+    {
+        const double miscorrections = heavy * claimed[m] / kSyndromes;
+        if (miscorrections <= config.MiscorrectionBudget && retransmits[m] < retransmits[mode])
+        {
+            mode = m;
+        }
+    }
+
+    policy->Mode.store(mode, std::memory_order_relaxed);
+    return mode;
+}
+
+extern "C" int crc16_ecc240_policy_mode(const crc16_ecc240_policy_t* policy)
+{
+    return policy->Mode.load(std::memory_order_relaxed);
+}
+
+extern "C" void crc16_ecc240_policy_counts(const crc16_ecc240_policy_t* policy, crc16_ecc240_policy_counts_t* counts)
+{
+    counts->Frames = policy->Counters[PolicyCounter_Frames].load(std::memory_order_relaxed);
+    counts->Clean = policy->Counters[PolicyCounter_Clean].load(std::memory_order_relaxed);
+    counts->Single = policy->Counters[PolicyCounter_Single].load(std::memory_order_relaxed);
+    counts->Burst = policy->Counters[PolicyCounter_Burst].load(std::memory_order_relaxed);
+    counts->Other = policy->Counters[PolicyCounter_Other].load(std::memory_order_relaxed);
+    counts->Rejected = policy->Counters[PolicyCounter_Rejected].load(std::memory_order_relaxed);
+}
+
+
+} // namespace crc16ecc240
@@ -0,0 +1,166 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_POLICY_h
+#define CRC16_ECC240_POLICY_h
+
+#include "crc16_ecc240.h"
+
+/*
+    Adaptive per-channel decoder policy.
+
+    Links differ: A clean link gains nothing from correction and only risks
+    accepting bad frames, while a link with frequent single-bit or short
+    burst errors saves a retransmit for every frame it repairs.  A policy
+    object per channel checks frames in one of three modes:
+
+        Detect:  Any error is rejected.
+        Single:  Single-bit errors are corrected.
+        Burst:   Bursts of up to 3 bits (patterns 1, 11, 101, 111) are
+                 corrected, which claims about four times as many syndromes.
+
+    Every frame is classified by its syndrome whatever the mode, so the
+    counters show what each mode would have done.  crc16_ecc240_policy_update()
+    folds the counters into decayed rates and picks the mode with the fewest
+    expected retransmits whose expected miscorrection rate is within budget.
+
+    Miscorrections come from heavier errors that happen to leave a syndrome
+    the decoder claims.  Those errors spread over all 65535 syndromes, so
+    the rate of heavy errors is estimated from frames whose syndrome matched
+    no burst, and a mode claiming K syndromes is charged K / 65535 of it.
+
+    The check functions only bump counters; they are meant for the thread
+    that owns the channel.  Updates may run on another thread, such as a
+    control loop, one at a time, and are cheap enough to call once per batch.
+*/
+
+#define CRC16_ECC240_POLICY_DETECT 0
+#define CRC16_ECC240_POLICY_SINGLE 1
+#define CRC16_ECC240_POLICY_BURST 2
+
+// Longest burst corrected in burst mode
+#define CRC16_ECC240_POLICY_MAX_BURST 3
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Burst Correction
+
+// Check a codeword produced by crc16_ecc240_encode_codeword(), correcting
+// any error burst of up to CRC16_ECC240_POLICY_MAX_BURST bits.
+//
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+//
+// Returns 0 on success.
+// Returns non-zero on failure to correct the frame.
+int crc16_ecc240_check_burst(uint8_t* frame, int totalBytes);
+
+
+//-----------------------------------------------------------------------------
+// API
+
+typedef struct crc16_ecc240_policy_config_t
+{
+    // Largest acceptable expected fraction of frames miscorrected
+    double MiscorrectionBudget;
+
+    // Decayed frame count needed before the mode can change
+    uint64_t MinFrames;
+
+    // Fraction of the history kept at each update, from 0 to 1
+    double Decay;
+
+    // Mode before enough frames have been seen
+    int InitialMode;
+} crc16_ecc240_policy_config_t;
+
+typedef struct crc16_ecc240_policy_counts_t
+{
+    uint64_t Frames;
+
+    // Frames by syndrome class
+    uint64_t Clean;
+    uint64_t Single;   // One bit in error
+    uint64_t Burst;    // A burst of 2 or 3 bits
+    uint64_t Other;    // Anything else
+
+    // Frames rejected in the mode in force at the time
+    uint64_t Rejected;
+} crc16_ecc240_policy_counts_t;
+
+typedef struct crc16_ecc240_policy_t crc16_ecc240_policy_t;
+
+// Create a policy for one channel.  'config' may be NULL for the defaults:
+// Budget 1e-9, MinFrames 10000, Decay 0.5, starting in single-bit mode.
+//
+// Returns NULL on failure.
+crc16_ecc240_policy_t* crc16_ecc240_policy_create(const crc16_ecc240_policy_config_t* config);
+
+// Free a policy
+void crc16_ecc240_policy_destroy(crc16_ecc240_policy_t* policy);
+
+// Check and correct one codeword in the current mode.
+//
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+//
+// Returns 0 if the frame was accepted, or -1 if it was rejected.
+int crc16_ecc240_policy_check(crc16_ecc240_policy_t* policy, uint8_t* frame, int totalBytes);
+
+// Check 'count' codewords spaced 'stride' bytes apart, in the current mode.
+// Rejected frames are flagged in the bitmap, laid out as for
+// crc16_ecc240_verify_many().  Counters are updated once per call.
+//
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+// Precondition: stride >= totalBytes
+//
+// Returns the number of frames rejected.
+int crc16_ecc240_policy_check_many(crc16_ecc240_policy_t* policy, uint8_t* frames, int totalBytes,
+                                   size_t stride, int count, uint64_t* bitmap);
+
+// Fold the counters since the last update into the decayed statistics and
+// choose the mode for the frames that follow.
+//
+// Returns the mode now in force.
+int crc16_ecc240_policy_update(crc16_ecc240_policy_t* policy);
+
+// Returns the mode in force
+int crc16_ecc240_policy_mode(const crc16_ecc240_policy_t* policy);
+
+// Read the counters since the policy was created
+void crc16_ecc240_policy_counts(const crc16_ecc240_policy_t* policy, crc16_ecc240_policy_counts_t* counts);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // CRC16_ECC240_POLICY_h
@@ -0,0 +1,181 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_pool.h"
+
+#include <mutex>
+#include <new>
+
+namespace crc16ecc240 {
+    struct PoolBlock;
+}
+
+struct crc16_ecc240_pool_t
+{
+    int DataBytes;
+
+    std::mutex Lock;
+    crc16ecc240::PoolBlock* FreeList;
+
+    // Every block ever allocated, for crc16_ecc240_pool_destroy()
+    crc16ecc240::PoolBlock* AllocatedList;
+};
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// Blocks
+
+// Block header plus the allocation that holds its arrays
+struct PoolBlock
+{
+    // Must be first: Callers see a pointer to this member
+    crc16_ecc240_block_t Block;
+
+    uint8_t* Allocation;
+    PoolBlock* NextFree;
+    PoolBlock* NextAllocated;
+};
+
+static PoolBlock* NewBlock(int dataBytes)
+{
+    static const size_t kDataBytes = CRC16_ECC240_POOL_BLOCK_FRAMES * CRC16_ECC240_BLOCK_SLOT_BYTES;
+    static const size_t kCRCBytes = CRC16_ECC240_POOL_BLOCK_FRAMES * sizeof(uint16_t);
+
+    PoolBlock* pb = new (std::nothrow) PoolBlock;
+    if (!pb)
+    {
+        return nullptr;
+    }
+
+    // Data then CRCs, in one allocation
+    pb->Allocation = new (std::nothrow) uint8_t[kDataBytes + kCRCBytes + CRC16_ECC240_CACHE_LINE_BYTES];
+    if (!pb->Allocation)
+    {
+        delete pb;
+        return nullptr;
+    }
+
+    // Align the data to a cache line
+    uintptr_t offset = (uintptr_t)pb->Allocation % CRC16_ECC240_CACHE_LINE_BYTES;
+    uint8_t* data = pb->Allocation + (offset ? CRC16_ECC240_CACHE_LINE_BYTES - offset : 0);
+
+    pb->Block.Data = data;
+    pb->Block.CRCs = reinterpret_cast<uint16_t*>(data + kDataBytes);
+    pb->Block.Count = 0;
+    pb->Block.Capacity = CRC16_ECC240_POOL_BLOCK_FRAMES;
+    pb->Block.DataBytes = dataBytes;
+    pb->NextFree = nullptr;
+    pb->NextAllocated = nullptr;
+    return pb;
+}
+
+
+//-----------------------------------------------------------------------------
+// API
+
+extern "C" crc16_ecc240_pool_t* crc16_ecc240_pool_create(int dataBytes)
+{
+    if (dataBytes <= 0 || (dataBytes & 1) || dataBytes > CRC16_ECC240_BLOCK_SLOT_BYTES - 2)
+    {
+        return nullptr;
+    }
+
+    crc16_ecc240_pool_t* pool = new (std::nothrow) crc16_ecc240_pool_t;
+    if (pool)
+    {
+        pool->DataBytes = dataBytes;
+        pool->FreeList = nullptr;
+        pool->AllocatedList = nullptr;
+    }
+    return pool;
+}
+
+extern "C" void crc16_ecc240_pool_destroy(crc16_ecc240_pool_t* pool)
+{
+    if (!pool)
+    {
+        return;
+    }
+
+    PoolBlock* pb = pool->AllocatedList;
+    while (pb)
+    {
+        PoolBlock* next = pb->NextAllocated;
+        delete[] pb->Allocation;
+        delete pb;
+        pb = next;
+    }
+
+    delete pool;
+}
+
+extern "C" crc16_ecc240_block_t* crc16_ecc240_pool_alloc(crc16_ecc240_pool_t* pool)
+{
+    {
+        std::lock_guard<std::mutex> locker(pool->Lock);
+
+        PoolBlock* pb = pool->FreeList;
+        if (pb)
+        {
+            pool->FreeList = pb->NextFree;
+            pb->Block.Count = 0;
+            return &pb->Block;
+        }
+    }
+
+    // Allocate outside the lock so other threads can keep recycling blocks
+    PoolBlock* pb = NewBlock(pool->DataBytes);
+    if (!pb)
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> locker(pool->Lock);
+    pb->NextAllocated = pool->AllocatedList;
+    pool->AllocatedList = pb;
+    return &pb->Block;
+}
+
+extern "C" void crc16_ecc240_pool_free(crc16_ecc240_pool_t* pool, crc16_ecc240_block_t* block)
+{
+    if (!block)
+    {
+        return;
+    }
+
+    PoolBlock* pb = reinterpret_cast<PoolBlock*>(block);
+
+    std::lock_guard<std::mutex> locker(pool->Lock);
+    pb->NextFree = pool->FreeList;
+    pool->FreeList = pb;
+}
+
+
+} // namespace crc16ecc240
@@ -0,0 +1,87 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_POOL_h
+#define CRC16_ECC240_POOL_h
+
+#include "crc16_ecc240.h"
+
+/*
+    Pool of struct-of-arrays frame blocks for the batch kernels.
+
+    Receivers that allocate each frame separately spend more time in malloc
+    than in the CRC, and scatter the frames across the heap so batch kernels
+    cannot stream through them.  A pool hands out whole blocks of
+    CRC16_ECC240_POOL_BLOCK_FRAMES frames instead, laid out as described for
+    crc16_ecc240_block_t: Data slots on a 64-byte boundary and the CRCs in
+    their own array.  Freed blocks go on a free list and are reused, so a
+    steady-state pipeline does not allocate at all.
+
+    Blocks are taken and returned under a lock, which is cheap since it is
+    once per block rather than once per frame.  A block itself belongs to
+    one thread at a time.
+*/
+
+// Frames per block: A multiple of 64 so bitmaps have no partial words
+#define CRC16_ECC240_POOL_BLOCK_FRAMES 256
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// API
+
+typedef struct crc16_ecc240_pool_t crc16_ecc240_pool_t;
+
+// Create a pool of blocks holding frames of 'dataBytes' each.
+//
+// Precondition: dataBytes > 0; dataBytes is even; dataBytes <= 30
+//
+// Returns NULL on failure.
+crc16_ecc240_pool_t* crc16_ecc240_pool_create(int dataBytes);
+
+// Free a pool and every block it allocated, including those still in use
+void crc16_ecc240_pool_destroy(crc16_ecc240_pool_t* pool);
+
+// Take a block from the pool.  Its Count is 0 and its contents are undefined.
+//
+// Returns NULL on failure.
+crc16_ecc240_block_t* crc16_ecc240_pool_alloc(crc16_ecc240_pool_t* pool);
+
+// Return a block to the pool it came from
+void crc16_ecc240_pool_free(crc16_ecc240_pool_t* pool, crc16_ecc240_block_t* block);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // CRC16_ECC240_POOL_h
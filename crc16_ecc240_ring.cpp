@@ -0,0 +1,189 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_ring.h"
+
+#include <atomic>
+
+struct crc16_ecc240_ring_t
+{
+    // Read-only after creation
+    size_t Mask;
+    uint8_t* Slots;
+    uint8_t* Allocation;
+
+    // Producer side: Its own index, and its last view of the consumer index
+    uint8_t ProducerPadding[CRC16_ECC240_CACHE_LINE_BYTES];
+    std::atomic<size_t> Tail;
+    size_t CachedHead;
+
+    // Consumer side: Its own index, and its last view of the producer index
+    uint8_t ConsumerPadding[CRC16_ECC240_CACHE_LINE_BYTES];
+    std::atomic<size_t> Head;
+    size_t CachedTail;
+
+    uint8_t EndPadding[CRC16_ECC240_CACHE_LINE_BYTES];
+};
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// API
+
+// Largest batch checked at once by crc16_ecc240_ring_check()
+static const int kMaxCheckBatch = 1024;
+
+extern "C" crc16_ecc240_ring_t* crc16_ecc240_ring_create(size_t slots)
+{
+    size_t size = 1;
+    while (size < slots)
+    {
+        size <<= 1;
+    }
+
+    crc16_ecc240_ring_t* ring = new crc16_ecc240_ring_t;
+    ring->Mask = size - 1;
+    ring->Allocation = new uint8_t[size * CRC16_ECC240_RING_SLOT_BYTES + CRC16_ECC240_CACHE_LINE_BYTES];
+
+    // Align the slots to a cache line
+    uintptr_t offset = (uintptr_t)ring->Allocation % CRC16_ECC240_CACHE_LINE_BYTES;
+    ring->Slots = ring->Allocation + (offset ? CRC16_ECC240_CACHE_LINE_BYTES - offset : 0);
+
+    ring->Tail.store(0, std::memory_order_relaxed);
+    ring->CachedHead = 0;
+    ring->Head.store(0, std::memory_order_relaxed);
+    ring->CachedTail = 0;
+    return ring;
+}
+
+extern "C" void crc16_ecc240_ring_destroy(crc16_ecc240_ring_t* ring)
+{
+    if (ring)
+    {
+        delete[] ring->Allocation;
+        delete ring;
+    }
+}
+
+extern "C" uint8_t* crc16_ecc240_ring_write_begin(crc16_ecc240_ring_t* ring, size_t maxCount, size_t* count)
+{
+    const size_t size = ring->Mask + 1;
+    const size_t tail = ring->Tail.load(std::memory_order_relaxed);
+
+    size_t space = size - (tail - ring->CachedHead);
+    if (space < maxCount)
+    {
+        // Slots the consumer released are safe to overwrite once seen
+        ring->CachedHead = ring->Head.load(std::memory_order_acquire);
+        space = size - (tail - ring->CachedHead);
+    }
+
+    const size_t index = tail & ring->Mask;
+    size_t n = maxCount < space ? maxCount : space;
+    if (n > size - index)
+    {
+        n = size - index;
+    }
+
+    *count = n;
+    return ring->Slots + index * CRC16_ECC240_RING_SLOT_BYTES;
+}
+
+extern "C" void crc16_ecc240_ring_write_commit(crc16_ecc240_ring_t* ring, size_t count)
+{
+    // Slot contents become visible before the new tail
+    ring->Tail.store(ring->Tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
+
+extern "C" uint8_t* crc16_ecc240_ring_read_begin(crc16_ecc240_ring_t* ring, size_t maxCount, size_t* count)
+{
+    const size_t size = ring->Mask + 1;
+    const size_t head = ring->Head.load(std::memory_order_relaxed);
+
+    size_t available = ring->CachedTail - head;
+    if (available < maxCount)
+    {
+        ring->CachedTail = ring->Tail.load(std::memory_order_acquire);
+        available = ring->CachedTail - head;
+    }
+
+    const size_t index = head & ring->Mask;
+    size_t n = maxCount < available ? maxCount : available;
+    if (n > size - index)
+    {
+        n = size - index;
+    }
+
+    *count = n;
+    return ring->Slots + index * CRC16_ECC240_RING_SLOT_BYTES;
+}
+
+extern "C" void crc16_ecc240_ring_read_commit(crc16_ecc240_ring_t* ring, size_t count)
+{
+    // Reads of the slots complete before the producer may reuse them
+    ring->Head.store(ring->Head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
+
+extern "C" int crc16_ecc240_ring_check(crc16_ecc240_ring_t* ring, int totalBytes, int maxCount,
+                                       crc16_ecc240_ring_deliver_t deliver, void* context,
+                                       crc16_ecc240_counts_t* counts)
+{
+    if (maxCount > kMaxCheckBatch)
+    {
+        maxCount = kMaxCheckBatch;
+    }
+
+    size_t taken;
+    uint8_t* frames = crc16_ecc240_ring_read_begin(ring, (size_t)maxCount, &taken);
+    if (taken == 0)
+    {
+        return 0;
+    }
+
+    const int count = (int)taken;
+    uint64_t failed[kMaxCheckBatch / 64];
+
+    int flagged = crc16_ecc240_verify_many(frames, totalBytes, CRC16_ECC240_RING_SLOT_BYTES, count, failed);
+    int failures = flagged ? crc16_ecc240_correct_many(frames, totalBytes, CRC16_ECC240_RING_SLOT_BYTES, count, failed) : 0;
+
+    counts->Clean += count - flagged;
+    counts->Corrected += flagged - failures;
+    counts->Failed += failures;
+
+    if (deliver)
+    {
+        deliver(context, frames, count, failed);
+    }
+
+    crc16_ecc240_ring_read_commit(ring, taken);
+    return count;
+}
+
+
+} // namespace crc16ecc240
@@ -0,0 +1,118 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_RING_h
+#define CRC16_ECC240_RING_h
+
+#include "crc16_ecc240_parallel.h"
+
+/*
+    Lock-free single-producer, single-consumer ring of frame slots.
+
+    Pipelines that receive, decode and deliver frames on separate cores pass
+    frames between stages through these rings instead of locked queues.
+
+    Each slot holds one codeword of up to CRC16_ECC240_RING_SLOT_BYTES, and
+    slots are contiguous, so a batch of slots can be handed straight to
+    crc16_ecc240_verify_many() without copying.  The producer and consumer
+    indices live on separate cache lines, and each side keeps a cached copy
+    of the other side's index so it only touches the shared line when its
+    cached view runs out.
+
+    Writers reserve slots with crc16_ecc240_ring_write_begin(), fill them,
+    and publish them with crc16_ecc240_ring_write_commit().  A full ring
+    reserves nothing, which is the backpressure signal to the producer.
+    Readers use the matching read functions.
+*/
+
+// Bytes per slot, one 32-byte codeword
+#define CRC16_ECC240_RING_SLOT_BYTES 32
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// API
+
+typedef struct crc16_ecc240_ring_t crc16_ecc240_ring_t;
+
+// Create a ring with 'slots' frame slots, rounded up to a power of two.
+// The slots are aligned to a cache line.
+//
+// Returns NULL on failure.
+crc16_ecc240_ring_t* crc16_ecc240_ring_create(size_t slots);
+
+// Free a ring.  Neither side may be using it.
+void crc16_ecc240_ring_destroy(crc16_ecc240_ring_t* ring);
+
+// Producer: Reserve up to 'maxCount' contiguous free slots.
+// '*count' receives the number reserved, which is 0 when the ring is full.
+// Fewer may be reserved where the ring wraps around.
+//
+// Returns a pointer to the first reserved slot.
+uint8_t* crc16_ecc240_ring_write_begin(crc16_ecc240_ring_t* ring, size_t maxCount, size_t* count);
+
+// Producer: Publish the first 'count' reserved slots to the consumer
+void crc16_ecc240_ring_write_commit(crc16_ecc240_ring_t* ring, size_t count);
+
+// Consumer: Take up to 'maxCount' contiguous filled slots.
+// '*count' receives the number taken, which is 0 when the ring is empty.
+//
+// Returns a pointer to the first slot taken.
+uint8_t* crc16_ecc240_ring_read_begin(crc16_ecc240_ring_t* ring, size_t maxCount, size_t* count);
+
+// Consumer: Release the first 'count' taken slots back to the producer
+void crc16_ecc240_ring_read_commit(crc16_ecc240_ring_t* ring, size_t count);
+
+// Called with each batch checked by crc16_ecc240_ring_check().
+// Frame i is at frames + i * CRC16_ECC240_RING_SLOT_BYTES and failed the
+// check if bit (i % 64) of failed[i / 64] is set.  Slots are released when
+// this returns, so copy out anything that must outlive the call.
+typedef void (*crc16_ecc240_ring_deliver_t)(void* context, uint8_t* frames, int count,
+                                            const uint64_t* failed);
+
+// Consumer: Take a batch of up to 'maxCount' frames, check and correct them
+// in place, pass them to 'deliver', and release the slots.
+// 'counts' is added to.
+//
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+//
+// Returns the number of frames processed, 0 if the ring was empty.
+int crc16_ecc240_ring_check(crc16_ecc240_ring_t* ring, int totalBytes, int maxCount,
+                            crc16_ecc240_ring_deliver_t deliver, void* context,
+                            crc16_ecc240_counts_t* counts);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // CRC16_ECC240_RING_h
@@ -0,0 +1,294 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_scrub.h"
+
+#include <vector>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// MappedFile
+
+MappedFile::MappedFile()
+{
+#ifdef _WIN32
+    File = INVALID_HANDLE_VALUE;
+    Mapping = nullptr;
+#else
+    File = -1;
+#endif
+    Data = nullptr;
+    Size = 0;
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const char* path, bool writable)
+{
+    Close();
+
+#ifdef _WIN32
+    File = ::CreateFileA(path, writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                         FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (File == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(File, &size))
+    {
+        Close();
+        return false;
+    }
+    Size = (uint64_t)size.QuadPart;
+
+    if (Size > 0)
+    {
+        Mapping = ::CreateFileMappingA(File, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+        if (!Mapping)
+        {
+            Close();
+            return false;
+        }
+
+        Data = (uint8_t*)::MapViewOfFile(Mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+        if (!Data)
+        {
+            Close();
+            return false;
+        }
+    }
+#else
+    File = ::open(path, writable ? O_RDWR : O_RDONLY);
+    if (File < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(File, &st) != 0)
+    {
+        Close();
+        return false;
+    }
+    Size = (uint64_t)st.st_size;
+
+    if (Size > 0)
+    {
+        void* data = ::mmap(nullptr, (size_t)Size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                            MAP_SHARED, File, 0);
+        if (data == MAP_FAILED)
+        {
+            Close();
+            return false;
+        }
+        Data = (uint8_t*)data;
+    }
+#endif
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (Data)
+    {
+        ::UnmapViewOfFile(Data);
+    }
+    if (Mapping)
+    {
+        ::CloseHandle(Mapping);
+        Mapping = nullptr;
+    }
+    if (File != INVALID_HANDLE_VALUE)
+    {
+        ::CloseHandle(File);
+        File = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (Data)
+    {
+        ::munmap(Data, (size_t)Size);
+    }
+    if (File >= 0)
+    {
+        ::close(File);
+        File = -1;
+    }
+#endif
+    Data = nullptr;
+    Size = 0;
+}
+
+void MappedFile::AdviseSequential()
+{
+#ifdef _WIN32
+    // Requested with FILE_FLAG_SEQUENTIAL_SCAN when the file was opened
+#else
+    if (Data)
+    {
+        ::madvise(Data, (size_t)Size, MADV_SEQUENTIAL);
+    }
+#endif
+}
+
+bool MappedFile::Flush()
+{
+    if (!Data)
+    {
+        return true;
+    }
+
+#ifdef _WIN32
+    return ::FlushViewOfFile(Data, 0) && ::FlushFileBuffers(File);
+#else
+    return ::msync(Data, (size_t)Size, MS_SYNC) == 0;
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// API
+
+// Frames checked per call to crc16_ecc240_verify_many()
+static const uint64_t kBatchFrames = 4096;
+
+static void ScrubRegion(uint8_t* data, int totalBytes, crc16_ecc240_scrub_region_t& region)
+{
+    uint64_t bitmap[kBatchFrames / 64];
+    uint8_t* frames = data + region.Offset;
+
+    memset(&region.Counts, 0, sizeof(region.Counts));
+
+    for (uint64_t i = 0; i < region.Frames; i += kBatchFrames)
+    {
+        int count = (int)((region.Frames - i < kBatchFrames) ? (region.Frames - i) : kBatchFrames);
+        uint8_t* batch = frames + i * totalBytes;
+
+        // Verification only reads, so clean pages are never dirtied
+        int flagged = crc16_ecc240_verify_many(batch, totalBytes, totalBytes, count, bitmap);
+        int failed = flagged ? crc16_ecc240_correct_many(batch, totalBytes, totalBytes, count, bitmap) : 0;
+
+        region.Counts.Clean += count - flagged;
+        region.Counts.Corrected += flagged - failed;
+        region.Counts.Failed += failed;
+    }
+}
+
+extern "C" int crc16_ecc240_scrub_file(const char* path, int totalBytes, uint64_t regionBytes,
+                                       crc16_ecc240_scrub_report_t report, void* context,
+                                       crc16_ecc240_counts_t* total)
+{
+    MappedFile file;
+    if (!file.Open(path, true))
+    {
+        return -1;
+    }
+
+    const uint64_t size = file.GetSize();
+    if (size % totalBytes != 0)
+    {
+        return -2;
+    }
+
+    file.AdviseSequential();
+
+    const uint64_t frameCount = size / totalBytes;
+    uint64_t regionFrames = regionBytes / totalBytes;
+    if (regionFrames < 1)
+    {
+        regionFrames = 1;
+    }
+
+    std::vector<crc16_ecc240_scrub_region_t> regions((size_t)((frameCount + regionFrames - 1) / regionFrames));
+    for (size_t i = 0; i < regions.size(); ++i)
+    {
+        regions[i].Offset = i * regionFrames * totalBytes;
+        regions[i].Frames = (frameCount - i * regionFrames < regionFrames) ? (frameCount - i * regionFrames) : regionFrames;
+    }
+
+    uint8_t* data = file.GetData();
+
+    // Each worker walks its own contiguous run of regions front to back
+    ParallelRun([&](int index, int workers) {
+        size_t begin, end;
+        ParallelSlice(regions.size(), workers, index, 1, begin, end);
+        for (size_t i = begin; i < end; ++i)
+        {
+            ScrubRegion(data, totalBytes, regions[i]);
+        }
+    });
+
+    crc16_ecc240_counts_t sum;
+    memset(&sum, 0, sizeof(sum));
+
+    for (size_t i = 0; i < regions.size(); ++i)
+    {
+        sum.Clean += regions[i].Counts.Clean;
+        sum.Corrected += regions[i].Counts.Corrected;
+        sum.Failed += regions[i].Counts.Failed;
+
+        if (report)
+        {
+            report(context, &regions[i]);
+        }
+    }
+
+    if (total)
+    {
+        *total = sum;
+    }
+
+    // Only pages holding corrected frames are dirty, so only they are written
+    if (sum.Corrected > 0 && !file.Flush())
+    {
+        return -3;
+    }
+
+    return 0;
+}
+
+
+} // namespace crc16ecc240
@@ -0,0 +1,134 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_SCRUB_h
+#define CRC16_ECC240_SCRUB_h
+
+#include "crc16_ecc240_parallel.h"
+
+/*
+    In-place scrubbing of files that hold back-to-back codewords.
+
+    The file is memory-mapped with shared write access, so frames are checked
+    directly in the page cache without read or write copies.  Only frames
+    that need correcting are written to, so only the pages holding them are
+    dirtied and written back to disk.
+
+    The file is divided into regions that are spread across the worker pool
+    from crc16_ecc240_parallel.h, and statistics are reported per region.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// API
+
+typedef struct crc16_ecc240_scrub_region_t
+{
+    // Byte offset of the first frame in the region
+    uint64_t Offset;
+
+    // Number of frames in the region
+    uint64_t Frames;
+
+    // Outcome of checking the frames in the region
+    crc16_ecc240_counts_t Counts;
+} crc16_ecc240_scrub_region_t;
+
+// Called once per region, in file order, after the scrub completes
+typedef void (*crc16_ecc240_scrub_report_t)(void* context, const crc16_ecc240_scrub_region_t* region);
+
+// Check and correct every codeword in a file in place.
+//
+// 'regionBytes' sets the granularity of the statistics and of the work split
+// between threads.  It is rounded down to a whole number of frames.
+// 'report' may be NULL.  'total' may be NULL.
+//
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+//
+// Returns 0 on success.
+// Returns -1 if the file could not be opened or mapped.
+// Returns -2 if the file size is not a whole number of frames.
+// Returns -3 if corrections could not be flushed to disk.
+int crc16_ecc240_scrub_file(const char* path, int totalBytes, uint64_t regionBytes,
+                            crc16_ecc240_scrub_report_t report, void* context,
+                            crc16_ecc240_counts_t* total);
+
+
+#ifdef __cplusplus
+}
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// C++ Tools
+
+/*
+    Memory-mapped view of a whole file.
+*/
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // Returns true on success
+    bool Open(const char* path, bool writable);
+    void Close();
+
+    // Hint that the mapping will be read front to back
+    void AdviseSequential();
+
+    // Write dirty pages back to disk.  Returns true on success
+    bool Flush();
+
+    uint8_t* GetData() const { return Data; }
+    uint64_t GetSize() const { return Size; }
+
+private:
+#ifdef _WIN32
+    void* File;
+    void* Mapping;
+#else
+    int File;
+#endif
+    uint8_t* Data;
+    uint64_t Size;
+};
+
+
+} // namespace crc16ecc240
+
+#endif // __cplusplus
+
+
+#endif // CRC16_ECC240_SCRUB_h
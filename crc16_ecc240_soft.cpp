@@ -0,0 +1,187 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_soft.h"
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// crc16_ecc240_check_soft
+
+extern "C" int crc16_ecc240_check_soft(uint8_t* frame, int totalBytes, const uint8_t* reliability,
+                                       int maxFlips, int maxCandidates)
+{
+    const uint16_t residue = crc16_ecc240_generate(frame, totalBytes);
+    if (residue == 0)
+    {
+        return 0;
+    }
+    if (maxFlips < 1)
+    {
+        return -1;
+    }
+
+    const int totalBits = totalBytes * 8;
+
+    // Number of least reliable bits to enumerate
+    int L = 0;
+    while (L < CRC16_ECC240_SOFT_MAX_LEAST_RELIABLE && L < totalBits &&
+           ((int64_t)1 << (L + 1)) <= maxCandidates)
+    {
+        ++L;
+    }
+
+    // Pick the L least reliable bit positions, kept sorted by reliability
+    int weak[CRC16_ECC240_SOFT_MAX_LEAST_RELIABLE];
+    int weakCount = 0;
+
+    for (int p = 0; p < totalBits && L > 0; ++p)
+    {
+        const uint8_t r = reliability[p];
+        if (weakCount == L && reliability[weak[L - 1]] <= r)
+        {
+            continue;
+        }
+
+        int i = (weakCount < L) ? weakCount++ : L - 1;
+        for (; i > 0 && reliability[weak[i - 1]] > r; --i)
+        {
+            weak[i] = weak[i - 1];
+        }
+        weak[i] = p;
+    }
+
+    // Syndrome change for flipping each of the weak bits
+    uint16_t weakSyndrome[CRC16_ECC240_SOFT_MAX_LEAST_RELIABLE];
+    for (int i = 0; i < L; ++i)
+    {
+        weakSyndrome[i] = BitResidue(totalBits - 1 - weak[i]);
+    }
+
+    // Best candidate so far
+    uint32_t bestMask = 0;
+    int bestExtra = -1; // Extra hard-decoded bit position, or -1
+    unsigned bestCost = ~0u;
+    bool found = false;
+
+    // Walk all 2^L flip patterns in Gray-code order
+    uint16_t syndrome = residue;
+    uint32_t mask = 0;
+    unsigned cost = 0;
+    int flips = 0;
+
+    for (uint32_t step = 0;; ++step)
+    {
+        if (flips <= maxFlips && cost < bestCost)
+        {
+            if (syndrome == 0)
+            {
+                bestMask = mask;
+                bestExtra = -1;
+                bestCost = cost;
+                found = true;
+            }
+            else if (flips < maxFlips)
+            {
+                // Let the hard decoder finish it with one more bit
+                int p;
+                const int errorClass = ClassifyResidue(syndrome, totalBits, p);
+                if (errorClass == CRC16_ECC240_CLASS_DATA_BIT || errorClass == CRC16_ECC240_CLASS_CRC_BIT)
+                {
+                    const unsigned total = cost + reliability[p];
+
+                    // A weak bit here is covered by the pattern that flips it
+                    bool isWeak = false;
+                    for (int i = 0; i < L; ++i)
+                    {
+                        isWeak |= (weak[i] == p);
+                    }
+
+                    if (!isWeak && total < bestCost)
+                    {
+                        bestMask = mask;
+                        bestExtra = p;
+                        bestCost = total;
+                        found = true;
+                    }
+                }
+            }
+        }
+
+        if (step + 1 >= ((uint32_t)1 << L))
+        {
+            break;
+        }
+
+        // Gray code: flip the lowest set bit of the next step number
+        int i = 0;
+        while (((step + 1) >> i & 1) == 0)
+        {
+            ++i;
+        }
+
+        mask ^= (uint32_t)1 << i;
+        syndrome ^= weakSyndrome[i];
+        if (mask >> i & 1)
+        {
+            cost += reliability[weak[i]];
+            ++flips;
+        }
+        else
+        {
+            cost -= reliability[weak[i]];
+            --flips;
+        }
+    }
+
+    if (!found)
+    {
+        return -1;
+    }
+
+    int flipped = 0;
+    for (int i = 0; i < L; ++i)
+    {
+        if (bestMask >> i & 1)
+        {
+            frame[weak[i] / 8] ^= (uint8_t)(0x80 >> (weak[i] % 8));
+            ++flipped;
+        }
+    }
+    if (bestExtra >= 0)
+    {
+        frame[bestExtra / 8] ^= (uint8_t)(0x80 >> (bestExtra % 8));
+        ++flipped;
+    }
+
+    return flipped;
+}
+
+
+} // namespace crc16ecc240
@@ -0,0 +1,89 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_SOFT_h
+#define CRC16_ECC240_SOFT_h
+
+#include "crc16_ecc240.h"
+
+/*
+    Soft-decision correction.
+
+    crc16_ecc240_check_codeword() only sees hard bits.  When the demodulator
+    also reports how reliable each bit is, most multi-bit errors sit on the
+    least reliable bits, and a Chase-style decoder can repair them:
+
+    The L least reliable bits are flipped in every combination, stepping in
+    Gray-code order so each candidate costs one xor of a single-bit syndrome
+    instead of a full CRC pass.  A candidate whose syndrome is zero is a valid
+    codeword, and one whose syndrome matches a single bit is completed by the
+    hard decoder.  The valid candidate with the lowest total reliability of
+    flipped bits wins.
+
+    The polynomial has HD=5 up to 240 data bits, so flips + undetected <= 4:
+    Allowing at most 1 flip keeps the hard-decoder guarantee of detecting any
+    3 blind errors, and 2 flips still detects any 2.  More flips lean on the
+    reliability values being trustworthy.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// API
+
+// Most bits flipped by enumeration; caps the candidate budget at 2^16
+#define CRC16_ECC240_SOFT_MAX_LEAST_RELIABLE 16
+
+// Decode a codeword using per-bit reliability, correcting it in place.
+//
+// reliability[i] rates bit i of the frame in transmission order (most
+// significant bit of each byte first, CRC bits last).  Higher is more
+// reliable; for example the magnitude of the log-likelihood ratio.
+//
+// maxFlips: Most bits the decoder may change, 1 matches the hard decoder.
+// maxCandidates: Budget of flip patterns to try.  The decoder enumerates the
+// largest power of two of patterns that fits.
+//
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+// Precondition: reliability has totalBytes * 8 entries
+//
+// Returns the number of bits flipped (0 for a clean frame) on success.
+// Returns -1 if no valid codeword was found, leaving the frame unchanged.
+int crc16_ecc240_check_soft(uint8_t* frame, int totalBytes, const uint8_t* reliability,
+                            int maxFlips, int maxCandidates);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // CRC16_ECC240_SOFT_h
@@ -0,0 +1,180 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_stream.h"
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// Framer
+
+static const int kFrameBytes = CRC16_ECC240_STREAM_FRAME_BYTES;
+static const int kPayloadBytes = CRC16_ECC240_STREAM_PAYLOAD_BYTES;
+
+extern "C" void crc16_ecc240_framer_init(crc16_ecc240_framer_t* framer)
+{
+    framer->PendingBytes = 0;
+}
+
+static CRC16_ECC240_FORCE_INLINE void FillFrame(uint8_t* frame, const uint8_t* payload, int bytes)
+{
+    frame[0] = (uint8_t)bytes;
+    memcpy(frame + 1, payload, bytes);
+    memset(frame + 1 + bytes, 0, kPayloadBytes - bytes);
+}
+
+extern "C" size_t crc16_ecc240_framer_write(crc16_ecc240_framer_t* framer, const void* vdata, size_t bytes,
+                                            const crc16_ecc240_iovec_t* out, int outCount, size_t* framesWritten)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(vdata);
+    size_t consumed = 0;
+    size_t written = 0;
+
+    for (int i = 0; i < outCount; ++i)
+    {
+        uint8_t* buffer = out[i].Data;
+        size_t capacity = out[i].Bytes / kFrameBytes;
+        size_t frames = 0;
+
+        // Complete the frame held over from the last call first
+        if (framer->PendingBytes > 0 && capacity > 0)
+        {
+            int needed = kPayloadBytes - framer->PendingBytes;
+            if (bytes - consumed < (size_t)needed)
+            {
+                break;
+            }
+
+            uint8_t* frame = buffer;
+            frame[0] = (uint8_t)kPayloadBytes;
+            memcpy(frame + 1, framer->Pending, framer->PendingBytes);
+            memcpy(frame + 1 + framer->PendingBytes, data + consumed, needed);
+            consumed += needed;
+            framer->PendingBytes = 0;
+            ++frames;
+        }
+
+        // Full frames straight from the input
+        while (frames < capacity && bytes - consumed >= (size_t)kPayloadBytes)
+        {
+            FillFrame(buffer + frames * kFrameBytes, data + consumed, kPayloadBytes);
+            consumed += kPayloadBytes;
+            ++frames;
+        }
+
+        // CRCs for the whole run of frames in this buffer at once
+        crc16_ecc240_encode_many(buffer, kFrameBytes, kFrameBytes, frames);
+        written += frames;
+
+        if (bytes - consumed < (size_t)kPayloadBytes)
+        {
+            break;
+        }
+    }
+
+    // Hold a tail that does not fill a frame
+    size_t left = bytes - consumed;
+    if (left > 0 && left + framer->PendingBytes < (size_t)kPayloadBytes)
+    {
+        memcpy(framer->Pending + framer->PendingBytes, data + consumed, left);
+        framer->PendingBytes += (int)left;
+        consumed = bytes;
+    }
+
+    if (framesWritten)
+    {
+        *framesWritten = written;
+    }
+    return consumed;
+}
+
+extern "C" int crc16_ecc240_framer_flush(crc16_ecc240_framer_t* framer, uint8_t* frame)
+{
+    if (framer->PendingBytes <= 0)
+    {
+        return 0;
+    }
+
+    FillFrame(frame, framer->Pending, framer->PendingBytes);
+    crc16_ecc240_encode_codeword(frame, kFrameBytes);
+    framer->PendingBytes = 0;
+    return 1;
+}
+
+
+//-----------------------------------------------------------------------------
+// Deframer
+
+// Frames checked per call to crc16_ecc240_verify_many()
+static const size_t kBatchFrames = 1024;
+
+extern "C" int crc16_ecc240_deframe(uint8_t* frames, size_t count, crc16_ecc240_iovec_t* payloads)
+{
+    uint64_t bitmap[kBatchFrames / 64];
+    int failures = 0;
+
+    for (size_t i = 0; i < count; i += kBatchFrames)
+    {
+        int batchCount = (int)((count - i < kBatchFrames) ? (count - i) : kBatchFrames);
+        uint8_t* batch = frames + i * kFrameBytes;
+
+        if (crc16_ecc240_verify_many(batch, kFrameBytes, kFrameBytes, batchCount, bitmap) > 0)
+        {
+            crc16_ecc240_correct_many(batch, kFrameBytes, kFrameBytes, batchCount, bitmap);
+        }
+        else
+        {
+            memset(bitmap, 0, sizeof(bitmap));
+        }
+
+        for (int j = 0; j < batchCount; ++j)
+        {
+            uint8_t* frame = batch + j * kFrameBytes;
+            crc16_ecc240_iovec_t& payload = payloads[i + j];
+
+            const bool failed = ((bitmap[j / 64] >> (j % 64)) & 1) != 0;
+            if (failed || frame[0] > kPayloadBytes)
+            {
+                payload.Data = nullptr;
+                payload.Bytes = 0;
+                ++failures;
+            }
+            else
+            {
+                payload.Data = frame + 1;
+                payload.Bytes = frame[0];
+            }
+        }
+    }
+
+    return failures;
+}
+
+
+} // namespace crc16ecc240
@@ -0,0 +1,119 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_STREAM_h
+#define CRC16_ECC240_STREAM_h
+
+#include "crc16_ecc240.h"
+
+/*
+    Stream framing over 32-byte codewords.
+
+    Arbitrary byte streams are cut into fixed frames:
+
+        +--------+------------------------+-------+
+        | Length | Payload (29 bytes)     | CRC16 |
+        +--------+------------------------+-------+
+          1 byte   zero padded past Length  2 bytes
+
+    Every frame but the last of a stream carries a full payload.  The CRC
+    covers the length byte and the padding, so a damaged length is caught
+    (and usually corrected) like any other bit.
+
+    Frames are written straight into caller-provided scatter buffers and
+    decoded in place, so the only copy is the one from the input stream into
+    the frame.  CRCs are computed in bulk with crc16_ecc240_encode_many() and
+    checked with crc16_ecc240_verify_many().
+*/
+
+// Bytes in one frame on the wire
+#define CRC16_ECC240_STREAM_FRAME_BYTES CRC16_ECC240_MAX_CODEWORD_BYTES
+
+// Payload bytes carried by one full frame
+#define CRC16_ECC240_STREAM_PAYLOAD_BYTES (CRC16_ECC240_STREAM_FRAME_BYTES - 3)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Framer
+
+typedef struct crc16_ecc240_framer_t
+{
+    // Input bytes that do not fill a frame yet
+    uint8_t Pending[CRC16_ECC240_STREAM_PAYLOAD_BYTES];
+    int PendingBytes;
+} crc16_ecc240_framer_t;
+
+void crc16_ecc240_framer_init(crc16_ecc240_framer_t* framer);
+
+// Pack stream bytes into frames.
+//
+// Frames are written back to back into the buffers of 'out' in order.  Each
+// buffer only receives whole frames; trailing space too small for a frame is
+// left untouched.  Input that does not fill a frame is held in the framer
+// until the next write or flush.
+//
+// 'framesWritten' receives the number of frames written.
+//
+// Returns the number of input bytes consumed.  This is less than 'bytes' only
+// when the output buffers are full; pass the rest in the next call.
+size_t crc16_ecc240_framer_write(crc16_ecc240_framer_t* framer, const void* data, size_t bytes,
+                                 const crc16_ecc240_iovec_t* out, int outCount, size_t* framesWritten);
+
+// Write the held bytes as a final short frame.
+//
+// Precondition: frame points to CRC16_ECC240_STREAM_FRAME_BYTES bytes
+//
+// Returns 1 if a frame was written.
+// Returns 0 if there was nothing to flush.
+int crc16_ecc240_framer_flush(crc16_ecc240_framer_t* framer, uint8_t* frame);
+
+
+//-----------------------------------------------------------------------------
+// Deframer
+
+// Check, correct and unpack received frames in place.
+//
+// Frames are CRC16_ECC240_STREAM_FRAME_BYTES apart.  payloads[i] receives a
+// pointer to the payload inside frame i and its length.  Frames that cannot be
+// corrected, or whose length byte is invalid, get a NULL pointer and a length
+// of zero.
+//
+// Returns the number of frames that failed.
+int crc16_ecc240_deframe(uint8_t* frames, size_t count, crc16_ecc240_iovec_t* payloads);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // CRC16_ECC240_STREAM_h
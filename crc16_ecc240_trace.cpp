@@ -0,0 +1,257 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_trace.h"
+
+#include <stdio.h>
+#include <vector>
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// Format
+
+static const uint8_t kMagic[8] = { 'E', '2', '4', '0', 'T', 'R', 'C', 'E' };
+
+// Bytes per record including padding
+static uint64_t RecordBytes(int frameBytes)
+{
+    return (8 + 2 * (uint64_t)frameBytes + 7) & ~(uint64_t)7;
+}
+
+static void WriteU32(uint8_t* p, uint32_t x)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        p[i] = (uint8_t)(x >> (8 * i));
+    }
+}
+
+static uint32_t ReadU32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+
+//-----------------------------------------------------------------------------
+// Recording
+
+extern "C" int crc16_ecc240_trace_create(crc16_ecc240_trace_writer_t* writer, const char* path, int frameBytes)
+{
+    writer->File = nullptr;
+    writer->FrameBytes = frameBytes;
+
+    if (frameBytes <= 0)
+    {
+        return -1;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file)
+    {
+        return -1;
+    }
+
+    uint8_t header[CRC16_ECC240_TRACE_HEADER_BYTES];
+    memcpy(header, kMagic, 8);
+    WriteU32(header + 8, CRC16_ECC240_TRACE_VERSION);
+    WriteU32(header + 12, (uint32_t)frameBytes);
+
+    if (fwrite(header, 1, sizeof(header), file) != sizeof(header))
+    {
+        fclose(file);
+        return -1;
+    }
+
+    writer->File = file;
+    return 0;
+}
+
+extern "C" int crc16_ecc240_trace_append(crc16_ecc240_trace_writer_t* writer, uint64_t timestamp,
+                                         const uint8_t* original, const uint8_t* received)
+{
+    FILE* file = (FILE*)writer->File;
+    const int frameBytes = writer->FrameBytes;
+
+    uint8_t prefix[8];
+    WriteU32(prefix, (uint32_t)timestamp);
+    WriteU32(prefix + 4, (uint32_t)(timestamp >> 32));
+
+    static const uint8_t kZeroes[8] = { 0 };
+    const size_t padding = (size_t)(RecordBytes(frameBytes) - 8 - 2 * (uint64_t)frameBytes);
+
+    if (!file ||
+        fwrite(prefix, 1, 8, file) != 8 ||
+        fwrite(original, 1, frameBytes, file) != (size_t)frameBytes ||
+        fwrite(received, 1, frameBytes, file) != (size_t)frameBytes ||
+        fwrite(kZeroes, 1, padding, file) != padding)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+extern "C" int crc16_ecc240_trace_close(crc16_ecc240_trace_writer_t* writer)
+{
+    FILE* file = (FILE*)writer->File;
+    writer->File = nullptr;
+
+    if (!file)
+    {
+        return -1;
+    }
+    return fclose(file) == 0 ? 0 : -1;
+}
+
+
+//-----------------------------------------------------------------------------
+// Replay
+
+// Below this many records the trace is replayed on the calling thread
+static const uint64_t kMinParallelRecords = 4096;
+
+static int DefaultDecoder(void* context, uint8_t* frame, int frameBytes)
+{
+    (void)context;
+    return crc16_ecc240_check_codeword(frame, frameBytes);
+}
+
+static void ReplaySlice(const uint8_t* records, int frameBytes, uint64_t begin, uint64_t end,
+                        crc16_ecc240_trace_decoder_t decoder, void* context,
+                        crc16_ecc240_trace_counts_t& counts)
+{
+    const uint64_t recordBytes = RecordBytes(frameBytes);
+    std::vector<uint8_t> frame(frameBytes);
+
+    for (uint64_t i = begin; i < end; ++i)
+    {
+        const uint8_t* original = records + i * recordBytes + 8;
+        const uint8_t* received = original + frameBytes;
+
+        // The mapping is read-only, so decode a copy
+        memcpy(&frame[0], received, frameBytes);
+
+        if (decoder(context, &frame[0], frameBytes) != 0)
+        {
+            ++counts.Rejected;
+        }
+        else if (0 != memcmp(&frame[0], original, frameBytes))
+        {
+            ++counts.Miscorrected;
+        }
+        else if (0 == memcmp(received, original, frameBytes))
+        {
+            ++counts.Clean;
+        }
+        else
+        {
+            ++counts.Corrected;
+        }
+    }
+}
+
+extern "C" int crc16_ecc240_trace_replay(const char* path, crc16_ecc240_trace_decoder_t decoder, void* context,
+                                         crc16_ecc240_trace_counts_t* counts)
+{
+    memset(counts, 0, sizeof(crc16_ecc240_trace_counts_t));
+
+    if (!decoder)
+    {
+        decoder = DefaultDecoder;
+    }
+
+    MappedFile file;
+    if (!file.Open(path, false))
+    {
+        return -1;
+    }
+
+    const uint64_t size = file.GetSize();
+    const uint8_t* data = file.GetData();
+
+    if (size < CRC16_ECC240_TRACE_HEADER_BYTES ||
+        0 != memcmp(data, kMagic, 8) ||
+        ReadU32(data + 8) != CRC16_ECC240_TRACE_VERSION)
+    {
+        return -2;
+    }
+
+    const uint32_t frameBytes = ReadU32(data + 12);
+    if (frameBytes == 0 || frameBytes > 0x7fffffff)
+    {
+        return -2;
+    }
+
+    const uint64_t recordBytes = RecordBytes((int)frameBytes);
+    if ((size - CRC16_ECC240_TRACE_HEADER_BYTES) % recordBytes != 0)
+    {
+        return -2;
+    }
+
+    const uint8_t* records = data + CRC16_ECC240_TRACE_HEADER_BYTES;
+    const uint64_t recordCount = (size - CRC16_ECC240_TRACE_HEADER_BYTES) / recordBytes;
+
+    file.AdviseSequential();
+
+    if (recordCount < kMinParallelRecords)
+    {
+        ReplaySlice(records, (int)frameBytes, 0, recordCount, decoder, context, *counts);
+        return 0;
+    }
+
+    // One cache line of counts per worker to avoid false sharing
+    struct PaddedCounts
+    {
+        crc16_ecc240_trace_counts_t Counts;
+        uint8_t Padding[CRC16_ECC240_CACHE_LINE_BYTES];
+    };
+    std::vector<PaddedCounts> perWorker(ParallelWorkerCount());
+
+    ParallelRun([&](int index, int workers) {
+        crc16_ecc240_trace_counts_t& local = perWorker[index].Counts;
+        memset(&local, 0, sizeof(local));
+
+        size_t begin, end;
+        ParallelSlice((size_t)recordCount, workers, index, 1, begin, end);
+        ReplaySlice(records, (int)frameBytes, begin, end, decoder, context, local);
+    });
+
+    for (size_t i = 0; i < perWorker.size(); ++i)
+    {
+        counts->Clean += perWorker[i].Counts.Clean;
+        counts->Corrected += perWorker[i].Counts.Corrected;
+        counts->Miscorrected += perWorker[i].Counts.Miscorrected;
+        counts->Rejected += perWorker[i].Counts.Rejected;
+    }
+
+    return 0;
+}
+
+
+} // namespace crc16ecc240
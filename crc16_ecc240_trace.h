@@ -0,0 +1,137 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_TRACE_h
+#define CRC16_ECC240_TRACE_h
+
+#include "crc16_ecc240_scrub.h"
+
+/*
+    Recording and replay of real channel errors.
+
+    Frames captured in the field are stored with the frame that was actually
+    sent, so a replay can tell whether a decoder restored the original,
+    rejected the frame, or accepted the wrong data.  Replaying the same trace
+    through several decoder configurations compares them against real
+    channel behavior instead of a synthetic error model.
+
+    File layout, all integers little-endian:
+
+        Header (16 bytes):
+            "E240TRCE"          Magic
+            uint32_t            CRC16_ECC240_TRACE_VERSION
+            uint32_t            Frame bytes
+
+        Records, each padded with zeroes to a multiple of 8 bytes:
+            uint64_t            Timestamp, in any unit the recorder chooses
+            uint8_t[frame]      Frame as sent
+            uint8_t[frame]      Frame as received
+
+    The replay memory-maps the trace and splits the records across the worker
+    pool from crc16_ecc240_parallel.h.
+*/
+
+#define CRC16_ECC240_TRACE_VERSION 1
+
+// Size of the file header
+#define CRC16_ECC240_TRACE_HEADER_BYTES 16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Recording
+
+typedef struct crc16_ecc240_trace_writer_t
+{
+    void* File;
+    int FrameBytes;
+} crc16_ecc240_trace_writer_t;
+
+// Create a trace file, replacing any existing file.
+//
+// Returns 0 on success.
+// Returns non-zero if the file could not be created.
+int crc16_ecc240_trace_create(crc16_ecc240_trace_writer_t* writer, const char* path, int frameBytes);
+
+// Append one captured frame.
+//
+// Returns 0 on success.
+// Returns non-zero on write failure.
+int crc16_ecc240_trace_append(crc16_ecc240_trace_writer_t* writer, uint64_t timestamp,
+                              const uint8_t* original, const uint8_t* received);
+
+// Finish writing the trace.
+//
+// Returns 0 on success.
+// Returns non-zero on write failure.
+int crc16_ecc240_trace_close(crc16_ecc240_trace_writer_t* writer);
+
+
+//-----------------------------------------------------------------------------
+// Replay
+
+typedef struct crc16_ecc240_trace_counts_t
+{
+    // Frames received without errors and accepted
+    uint64_t Clean;
+
+    // Frames with errors that the decoder restored to the original
+    uint64_t Corrected;
+
+    // Frames accepted by the decoder that differ from the original
+    uint64_t Miscorrected;
+
+    // Frames the decoder rejected
+    uint64_t Rejected;
+} crc16_ecc240_trace_counts_t;
+
+// Decoder under test: Correct the frame in place and return 0 to accept it,
+// or return non-zero to reject it.  Called from several threads at once.
+typedef int (*crc16_ecc240_trace_decoder_t)(void* context, uint8_t* frame, int frameBytes);
+
+// Run every received frame in a trace through a decoder and tally outcomes.
+// The trace file is not modified.
+//
+// 'decoder' may be NULL to use crc16_ecc240_check_codeword().
+//
+// Returns 0 on success.
+// Returns -1 if the file could not be opened or mapped.
+// Returns -2 if the file is not a valid trace.
+int crc16_ecc240_trace_replay(const char* path, crc16_ecc240_trace_decoder_t decoder, void* context,
+                              crc16_ecc240_trace_counts_t* counts);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // CRC16_ECC240_TRACE_h
@@ -0,0 +1,443 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "crc16_ecc240_udp.h"
+
+#include <vector>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #pragma comment(lib, "ws2_32.lib")
+    typedef SOCKET SocketT;
+    static const SocketT kInvalidSocket = INVALID_SOCKET;
+#else
+    #include <arpa/inet.h>
+    #include <errno.h>
+    #include <netinet/in.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+    typedef int SocketT;
+    static const SocketT kInvalidSocket = -1;
+#endif
+
+// Receiver state, opaque to callers
+struct crc16_ecc240_udp_t
+{
+    SocketT Socket;
+    int TotalBytes;
+    int BatchFrames;
+    bool Connected;
+
+    // BatchFrames receive buffers, CRC16_ECC240_UDP_BUFFER_STRIDE bytes apart
+    std::vector<uint8_t> Buffers;
+    std::vector<int> Lengths;
+
+    // Frames flagged by verification, then frames to drop
+    std::vector<uint64_t> Flagged;
+    std::vector<uint64_t> Dropped;
+
+    // Bitmap for one run of well-formed frames
+    std::vector<uint64_t> RunBitmap;
+
+#if defined(__linux__)
+    std::vector<mmsghdr> Messages;
+    std::vector<iovec> Vectors;
+#endif
+};
+
+namespace crc16ecc240 {
+
+
+//-----------------------------------------------------------------------------
+// Socket helpers
+
+static void CloseSocket(SocketT s)
+{
+#ifdef _WIN32
+    ::closesocket(s);
+#else
+    ::close(s);
+#endif
+}
+
+// Returns true if the address parsed
+static bool MakeAddress(const char* address, uint16_t port, sockaddr_in& addr)
+{
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    return 1 == ::inet_pton(AF_INET, address, &addr.sin_addr);
+}
+
+// Wait until the socket is readable.  Returns 1 if readable, 0 on timeout,
+// or -1 on failure
+static int WaitReadable(SocketT s, int timeoutMsec)
+{
+#ifdef _WIN32
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(s, &readSet);
+    timeval tv;
+    tv.tv_sec = timeoutMsec / 1000;
+    tv.tv_usec = (timeoutMsec % 1000) * 1000;
+    int result = ::select(0, &readSet, nullptr, nullptr, &tv);
+    return result == SOCKET_ERROR ? -1 : (result > 0 ? 1 : 0);
+#else
+    pollfd pfd;
+    pfd.fd = s;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    int result;
+    do
+    {
+        result = ::poll(&pfd, 1, timeoutMsec);
+    } while (result < 0 && errno == EINTR);
+    return result < 0 ? -1 : (result > 0 ? 1 : 0);
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// Receiver
+
+// Receive up to one batch into the buffers.  Returns the count or -1
+static int ReceiveBatch(crc16_ecc240_udp_t* udp)
+{
+    uint8_t* buffers = &udp->Buffers[0];
+
+#if defined(__linux__)
+    for (int i = 0; i < udp->BatchFrames; ++i)
+    {
+        udp->Vectors[i].iov_base = buffers + i * CRC16_ECC240_UDP_BUFFER_STRIDE;
+        udp->Vectors[i].iov_len = CRC16_ECC240_UDP_BUFFER_STRIDE;
+        memset(&udp->Messages[i], 0, sizeof(mmsghdr));
+        udp->Messages[i].msg_hdr.msg_iov = &udp->Vectors[i];
+        udp->Messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int count;
+    do
+    {
+        // Everything that is already queued, in one call
+        count = ::recvmmsg(udp->Socket, &udp->Messages[0], udp->BatchFrames, MSG_DONTWAIT, nullptr);
+    } while (count < 0 && errno == EINTR);
+
+    if (count < 0)
+    {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        udp->Lengths[i] = (udp->Messages[i].msg_hdr.msg_flags & MSG_TRUNC) ? -1 : (int)udp->Messages[i].msg_len;
+    }
+    return count;
+#else
+    int count = 0;
+    while (count < udp->BatchFrames)
+    {
+        char* buffer = (char*)(buffers + count * CRC16_ECC240_UDP_BUFFER_STRIDE);
+#ifdef _WIN32
+        u_long pending = 0;
+        if (::ioctlsocket(udp->Socket, FIONREAD, &pending) != 0 || pending == 0)
+        {
+            break;
+        }
+        int bytes = ::recv(udp->Socket, buffer, CRC16_ECC240_UDP_BUFFER_STRIDE, 0);
+        if (bytes < 0 && ::WSAGetLastError() == WSAEMSGSIZE)
+        {
+            bytes = CRC16_ECC240_UDP_BUFFER_STRIDE + 1; // Truncated
+        }
+#else
+        ssize_t bytes = ::recv(udp->Socket, buffer, CRC16_ECC240_UDP_BUFFER_STRIDE, MSG_DONTWAIT);
+        if (bytes < 0 && errno == EINTR)
+        {
+            continue;
+        }
+#endif
+        if (bytes < 0)
+        {
+            break;
+        }
+        udp->Lengths[count++] = (int)bytes;
+    }
+    return count;
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// API
+
+extern "C" crc16_ecc240_udp_t* crc16_ecc240_udp_open(const char* address, uint16_t port,
+                                                     int totalBytes, int batchFrames)
+{
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (0 != ::WSAStartup(MAKEWORD(2, 2), &wsaData))
+    {
+        return nullptr;
+    }
+#endif
+
+    sockaddr_in addr;
+    if (batchFrames < 1 || !MakeAddress(address, port, addr))
+    {
+        return nullptr;
+    }
+
+    SocketT s = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == kInvalidSocket)
+    {
+        return nullptr;
+    }
+
+    // Room for bursts that arrive while a batch is being decoded
+    int bufferBytes = 4 << 20;
+    ::setsockopt(s, SOL_SOCKET, SO_RCVBUF, (const char*)&bufferBytes, sizeof(bufferBytes));
+
+    if (0 != ::bind(s, (const sockaddr*)&addr, sizeof(addr)))
+    {
+        CloseSocket(s);
+        return nullptr;
+    }
+
+    crc16_ecc240_udp_t* udp = new crc16_ecc240_udp_t;
+    udp->Socket = s;
+    udp->TotalBytes = totalBytes;
+    udp->BatchFrames = batchFrames;
+    udp->Connected = false;
+    udp->Buffers.resize((size_t)batchFrames * CRC16_ECC240_UDP_BUFFER_STRIDE);
+    udp->Lengths.resize(batchFrames);
+    udp->Flagged.resize((batchFrames + 63) / 64);
+    udp->Dropped.resize((batchFrames + 63) / 64);
+    udp->RunBitmap.resize((batchFrames + 63) / 64);
+#if defined(__linux__)
+    udp->Messages.resize(batchFrames);
+    udp->Vectors.resize(batchFrames);
+#endif
+    return udp;
+}
+
+extern "C" uint16_t crc16_ecc240_udp_port(const crc16_ecc240_udp_t* udp)
+{
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (0 != ::getsockname(udp->Socket, (sockaddr*)&addr, &len))
+    {
+        return 0;
+    }
+    return ntohs(addr.sin_port);
+}
+
+extern "C" int crc16_ecc240_udp_connect(crc16_ecc240_udp_t* udp, const char* address, uint16_t port)
+{
+    sockaddr_in addr;
+    if (!MakeAddress(address, port, addr) ||
+        0 != ::connect(udp->Socket, (const sockaddr*)&addr, sizeof(addr)))
+    {
+        return -1;
+    }
+    udp->Connected = true;
+    return 0;
+}
+
+extern "C" int crc16_ecc240_udp_send(crc16_ecc240_udp_t* udp, const uint8_t* frames, size_t stride, int count)
+{
+    if (!udp->Connected)
+    {
+        return -1;
+    }
+
+#if defined(__linux__)
+    std::vector<mmsghdr> messages(count);
+    std::vector<iovec> vectors(count);
+    for (int i = 0; i < count; ++i)
+    {
+        vectors[i].iov_base = (void*)(frames + i * stride);
+        vectors[i].iov_len = udp->TotalBytes;
+        memset(&messages[i], 0, sizeof(mmsghdr));
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int sent = 0;
+    while (sent < count)
+    {
+        int result = ::sendmmsg(udp->Socket, &messages[sent], count - sent, 0);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return sent > 0 ? sent : -1;
+        }
+        sent += result;
+    }
+    return sent;
+#else
+    for (int i = 0; i < count; ++i)
+    {
+        if (::send(udp->Socket, (const char*)(frames + i * stride), udp->TotalBytes, 0) != udp->TotalBytes)
+        {
+            return i > 0 ? i : -1;
+        }
+    }
+    return count;
+#endif
+}
+
+// Check and correct 'runCount' well-formed frames starting at 'first',
+// setting their bits in the Flagged and Dropped bitmaps
+static void CheckRun(crc16_ecc240_udp_t* udp, int first, int runCount)
+{
+    const size_t stride = CRC16_ECC240_UDP_BUFFER_STRIDE;
+    uint8_t* frames = &udp->Buffers[0] + first * stride;
+    uint64_t* run = &udp->RunBitmap[0];
+
+    // Check the whole run, then correct only the flagged frames
+    if (0 == crc16_ecc240_verify_many(frames, udp->TotalBytes, stride, runCount, run))
+    {
+        return;
+    }
+    for (int j = 0; j < runCount; ++j)
+    {
+        if ((run[j / 64] >> (j % 64)) & 1)
+        {
+            udp->Flagged[(first + j) / 64] |= (uint64_t)1 << ((first + j) % 64);
+        }
+    }
+
+    crc16_ecc240_correct_many(frames, udp->TotalBytes, stride, runCount, run);
+    for (int j = 0; j < runCount; ++j)
+    {
+        if ((run[j / 64] >> (j % 64)) & 1)
+        {
+            udp->Dropped[(first + j) / 64] |= (uint64_t)1 << ((first + j) % 64);
+        }
+    }
+}
+
+extern "C" int crc16_ecc240_udp_receive(crc16_ecc240_udp_t* udp, int timeoutMsec,
+                                        crc16_ecc240_udp_forward_t forward, void* context,
+                                        crc16_ecc240_udp_counts_t* counts)
+{
+    int ready = WaitReadable(udp->Socket, timeoutMsec);
+    if (ready <= 0)
+    {
+        return ready;
+    }
+
+    int count = ReceiveBatch(udp);
+    if (count <= 0)
+    {
+        return count;
+    }
+
+    const size_t stride = CRC16_ECC240_UDP_BUFFER_STRIDE;
+    uint8_t* frames = &udp->Buffers[0];
+    uint64_t* flagged = &udp->Flagged[0];
+    uint64_t* dropped = &udp->Dropped[0];
+    const int words = (count + 63) / 64;
+
+    memset(flagged, 0, words * sizeof(uint64_t));
+    memset(dropped, 0, words * sizeof(uint64_t));
+
+    // Drop short and truncated datagrams up front, and check each run of
+    // well-formed frames between them, so that stale buffer contents are
+    // never corrected or tallied in the library statistics
+    int begin = 0;
+    while (begin < count)
+    {
+        if (udp->Lengths[begin] != udp->TotalBytes)
+        {
+            dropped[begin / 64] |= (uint64_t)1 << (begin % 64);
+            ++counts->Malformed;
+            ++begin;
+            continue;
+        }
+
+        int end = begin + 1;
+        while (end < count && udp->Lengths[end] == udp->TotalBytes)
+        {
+            ++end;
+        }
+
+        CheckRun(udp, begin, end - begin);
+        begin = end;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        const uint64_t bit = (uint64_t)1 << (i % 64);
+
+        if (udp->Lengths[i] != udp->TotalBytes)
+        {
+            continue; // Counted as malformed above
+        }
+
+        if ((flagged[i / 64] & bit) == 0)
+        {
+            ++counts->Clean;
+        }
+        else if (dropped[i / 64] & bit)
+        {
+            ++counts->Failed;
+        }
+        else
+        {
+            ++counts->Corrected;
+        }
+    }
+
+    if (forward)
+    {
+        forward(context, frames, stride, count, dropped);
+    }
+
+    return count;
+}
+
+extern "C" void crc16_ecc240_udp_close(crc16_ecc240_udp_t* udp)
+{
+    if (udp)
+    {
+        CloseSocket(udp->Socket);
+        delete udp;
+#ifdef _WIN32
+        ::WSACleanup();
+#endif
+    }
+}
+
+
+} // namespace crc16ecc240
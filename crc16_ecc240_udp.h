@@ -0,0 +1,126 @@
+/*
+	Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice,
+	  this list of conditions and the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice,
+	  this list of conditions and the following disclaimer in the documentation
+	  and/or other materials provided with the distribution.
+	* Neither the name of CRC16_ECC240 nor the names of its contributors may be
+	  used to endorse or promote products derived from this software without
+	  specific prior written permission.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+	AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+	IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+	ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+	LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+	CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+	SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+	INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+	CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+	ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CRC16_ECC240_UDP_h
+#define CRC16_ECC240_UDP_h
+
+#include "crc16_ecc240.h"
+
+/*
+    Batched UDP receive and decode.
+
+    Each datagram carries one codeword.  Receiving and checking datagrams
+    one at a time costs a system call and a full decode per packet.  This
+    receiver instead pulls a whole batch of datagrams into a fixed array of
+    buffers with one recvmmsg() call on Linux, then checks the batch in
+    place with crc16_ecc240_verify_many() and corrects only the flagged
+    frames, so the frames are never copied before they are forwarded.
+
+    Other platforms fall back to draining the socket without blocking after
+    the first datagram arrives, which still batches the decode.
+
+    The same object can send batches with sendmmsg(), which is enough to
+    exercise the receiver over the loopback interface.
+*/
+
+// Bytes between receive buffers; datagrams longer than a codeword are dropped
+#define CRC16_ECC240_UDP_BUFFER_STRIDE 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//-----------------------------------------------------------------------------
+// API
+
+typedef struct crc16_ecc240_udp_t crc16_ecc240_udp_t;
+
+typedef struct crc16_ecc240_udp_counts_t
+{
+    // Datagrams that arrived without errors
+    uint64_t Clean;
+
+    // Datagrams that had an error corrected
+    uint64_t Corrected;
+
+    // Datagrams dropped because they could not be corrected
+    uint64_t Failed;
+
+    // Datagrams dropped because they were not one codeword long
+    uint64_t Malformed;
+} crc16_ecc240_udp_counts_t;
+
+// Called once per received batch.
+// Frame i is at frames + i * stride and should be forwarded unless bit
+// (i % 64) of dropped[i / 64] is set.  The frames may be modified.
+typedef void (*crc16_ecc240_udp_forward_t)(void* context, uint8_t* frames, size_t stride,
+                                           int count, const uint64_t* dropped);
+
+// Open a UDP socket bound to an IPv4 address and port.
+// 'port' may be 0 to pick a free port; see crc16_ecc240_udp_port().
+//
+// Precondition: totalBytes >= 4; totalBytes is even; totalBytes <= 32
+// Precondition: batchFrames >= 1
+//
+// Returns NULL on failure.
+crc16_ecc240_udp_t* crc16_ecc240_udp_open(const char* address, uint16_t port,
+                                          int totalBytes, int batchFrames);
+
+// Returns the local port the socket is bound to
+uint16_t crc16_ecc240_udp_port(const crc16_ecc240_udp_t* udp);
+
+// Set the destination for crc16_ecc240_udp_send().
+//
+// Returns 0 on success.
+// Returns non-zero on failure.
+int crc16_ecc240_udp_connect(crc16_ecc240_udp_t* udp, const char* address, uint16_t port);
+
+// Send 'count' codewords as one datagram each.
+//
+// Returns the number of datagrams sent, or -1 on failure.
+int crc16_ecc240_udp_send(crc16_ecc240_udp_t* udp, const uint8_t* frames, size_t stride, int count);
+
+// Wait up to 'timeoutMsec' for datagrams, receive up to one batch, check and
+// correct it in place, and pass it to 'forward'.  'counts' is added to.
+//
+// Returns the number of datagrams received, 0 on timeout, or -1 on failure.
+int crc16_ecc240_udp_receive(crc16_ecc240_udp_t* udp, int timeoutMsec,
+                             crc16_ecc240_udp_forward_t forward, void* context,
+                             crc16_ecc240_udp_counts_t* counts);
+
+// Close the socket and free the receiver
+void crc16_ecc240_udp_close(crc16_ecc240_udp_t* udp);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // CRC16_ECC240_UDP_h
@@ -14,6 +14,11 @@
 // gives HD=5, 6, and 7 profile of CRC-32 (skips slow HD computations)
 //   0x82608edb {?,?,2974,268,171,?,?,?,?,?,?,?,?}
 //  the "?" entries avoid confusion about which weights were computed
+// With OPTZ, setting the HDLEN_CACHE environment variable to a file name
+//   (e.g. HDLEN_CACHE=hdlen.cache) keeps results in a memory-mapped cache
+//   file, so repeated queries for the same polynomial and HD print at once
+//   without searching.  It is off by default, and the unoptimized build
+//   never uses it so that validation runs always search
 // Each "example" shown in output is a minimum-length codeword at the HD 
 //     Example: Len=2975 {0,2215,2866} (0x80000000) (Bits=4)
 //  means a 2975 bit long data word with first bit (bit zero) set, bits 2215
@@ -41,6 +46,16 @@
 #include <stdint.h>
 #include <string>
 #include <inttypes.h>
+#include <vector>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 using namespace std;
 
 //#define OPTZ  // If defined invokes some algorithmic optimizations
@@ -224,6 +239,9 @@ public:
     void SetLen(Length_t len);       // Record length for bit positioning
     void SetBitPosn(Count_t bitIndex, Length_t posn); // Record codeword bit
     void PrintBits(Length_t dataWordLen);             // Print example codeword
+    Poly_t   GetFCS() const { return(uFCS); }         // Retrieve FCS
+    Length_t GetBitPosn(Count_t bitIndex) const       // Retrieve codeword bit
+        { return(posnList[bitIndex]); }
 };
 
 // Init undetected bit position data structure
@@ -299,6 +317,271 @@ ostream& operator <<(ostream& uout, const UndetectedClass& uval)
     return uout;
 }
 
+//////////////////////  Memory-mapped cache of HD results //////////////////////
+
+// File layout: one header, then an open-addressed hash table of slots keyed
+//   by (poly, HD).  The table is used in place through the mapping, so a
+//   lookup touches one or two slots and never reads the rest of the file.
+//   Each HD is stored as soon as it is found, so an interrupted run keeps
+//   the HDs it finished.  Only one hdlen should write a cache at a time.
+
+static const char     cacheMagic[8] = { 'H','D','L','E','N','C','A','C' };
+static const uint32_t cacheVersion = 1;
+static const uint32_t cacheInitialSlots = 256;  // power of two
+
+struct HDCacheHeader
+{
+    char     magic[8];       // cacheMagic
+    uint32_t version;        // cacheVersion
+    uint32_t slotCount;      // hash table size, power of two
+    uint64_t usedCount;      // slots holding results
+};
+
+struct HDCacheSlot
+{
+    Poly_t   poly;           // 0 marks an empty slot (not a valid poly)
+    uint32_t hd;
+    uint32_t reserved;
+    Length_t len;            // as HDLen
+    Poly_t   fcs;            // example codeword, as UndetectedClass
+    Length_t posnList[maxNumWeights];
+};
+
+class HDCacheClass
+{
+private:
+    HDCacheHeader * cHeader;  // start of mapping; NULL if not open
+    HDCacheSlot *   cSlots;   // hash table following the header
+    size_t          cBytes;   // size of mapping
+#ifdef _WIN32
+    HANDLE cFile;
+    HANDLE cMapping;
+#else
+    int    cFile;
+#endif
+
+    Flag_t Map(size_t bytes);        // (Re)map file at this size
+    void   Unmap();                  // Release mapping only
+    Flag_t Grow();                   // Double table and rehash
+    HDCacheSlot * Slot(Poly_t poly, Count_t hd);  // Slot for key or empty
+
+public:
+    HDCacheClass();
+    ~HDCacheClass();
+    Flag_t Open(const char * path);  // Open or create; 1 on success
+    void   Close();
+    Flag_t Find(Poly_t poly, Count_t hd,               // Look up one result
+        Length_t &len, UndetectedClass * example);
+    void   Store(Poly_t poly, Count_t hd,              // Record one result
+        Length_t len, const UndetectedClass * example);
+};
+
+// Size of a cache file holding this many slots
+inline size_t CacheBytes(uint32_t slotCount)
+{
+    return(sizeof(HDCacheHeader) + (size_t)slotCount * sizeof(HDCacheSlot));
+}
+
+// Starting slot for a key
+inline uint32_t CacheHash(Poly_t poly, Count_t hd)
+{
+    Poly_t key = (poly ^ ((Poly_t)hd << 56)) * 0x9E3779B97F4A7C15ULL;
+    return((uint32_t)(key >> 32));
+}
+
+HDCacheClass::HDCacheClass()
+{
+    cHeader = 0;
+    cSlots = 0;
+    cBytes = 0;
+#ifdef _WIN32
+    cFile = INVALID_HANDLE_VALUE;
+    cMapping = 0;
+#else
+    cFile = -1;
+#endif
+}
+
+HDCacheClass::~HDCacheClass()
+{
+    Close();
+}
+
+// Resize the file if needed and map all of it read/write
+Flag_t HDCacheClass::Map(size_t bytes)
+{
+    Unmap();
+#ifdef _WIN32
+    LARGE_INTEGER size;
+    size.QuadPart = (LONGLONG)bytes;
+    if (!::SetFilePointerEx(cFile, size, 0, FILE_BEGIN) || !::SetEndOfFile(cFile))
+    {
+        return(0);
+    }
+    cMapping = ::CreateFileMappingA(cFile, 0, PAGE_READWRITE, 0, 0, 0);
+    if (!cMapping) { return(0); }
+    void * data = ::MapViewOfFile(cMapping, FILE_MAP_WRITE, 0, 0, 0);
+    if (!data) { return(0); }
+#else
+    if (::ftruncate(cFile, (off_t)bytes) != 0) { return(0); }
+    void * data = ::mmap(0, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, cFile, 0);
+    if (data == MAP_FAILED) { return(0); }
+#endif
+    cHeader = (HDCacheHeader *)data;
+    cSlots = (HDCacheSlot *)(cHeader + 1);
+    cBytes = bytes;
+    return(1);
+}
+
+void HDCacheClass::Unmap()
+{
+#ifdef _WIN32
+    if (cHeader) { ::UnmapViewOfFile(cHeader); }
+    if (cMapping) { ::CloseHandle(cMapping); }
+    cMapping = 0;
+#else
+    if (cHeader) { ::munmap(cHeader, cBytes); }
+#endif
+    cHeader = 0;
+    cSlots = 0;
+    cBytes = 0;
+}
+
+// Open an existing cache, or start a new one if missing or unreadable
+Flag_t HDCacheClass::Open(const char * path)
+{
+    Close();
+
+#ifdef _WIN32
+    cFile = ::CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+        0, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+    if (cFile == INVALID_HANDLE_VALUE) { return(0); }
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(cFile, &size)) { Close(); return(0); }
+    size_t fileBytes = (size_t)size.QuadPart;
+#else
+    cFile = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (cFile < 0) { return(0); }
+    struct stat st;
+    if (::fstat(cFile, &st) != 0) { Close(); return(0); }
+    size_t fileBytes = (size_t)st.st_size;
+#endif
+
+    // Use the file as is if its header describes it exactly
+    if (fileBytes >= sizeof(HDCacheHeader) && Map(fileBytes))
+    {
+        uint32_t slotCount = cHeader->slotCount;
+        if (memcmp(cHeader->magic, cacheMagic, sizeof(cacheMagic)) == 0
+            && (cHeader->version == cacheVersion)
+            && (slotCount != 0) && ((slotCount & (slotCount - 1)) == 0)
+            && (CacheBytes(slotCount) == fileBytes)
+            )
+        {
+            return(1);
+        }
+    }
+
+    // Otherwise start over with an empty table
+    if (!Map(CacheBytes(cacheInitialSlots))) { Close(); return(0); }
+    memset(cHeader, 0, cBytes);
+    memcpy(cHeader->magic, cacheMagic, sizeof(cacheMagic));
+    cHeader->version = cacheVersion;
+    cHeader->slotCount = cacheInitialSlots;
+    return(1);
+}
+
+void HDCacheClass::Close()
+{
+    Unmap();
+#ifdef _WIN32
+    if (cFile != INVALID_HANDLE_VALUE) { ::CloseHandle(cFile); }
+    cFile = INVALID_HANDLE_VALUE;
+#else
+    if (cFile >= 0) { ::close(cFile); }
+    cFile = -1;
+#endif
+}
+
+// Find the slot holding a key, or the empty slot where it would go
+HDCacheSlot * HDCacheClass::Slot(Poly_t poly, Count_t hd)
+{
+    const uint32_t mask = cHeader->slotCount - 1;
+    uint32_t index = CacheHash(poly, hd) & mask;
+    while (cSlots[index].poly != 0)
+    {
+        if ((cSlots[index].poly == poly) && (cSlots[index].hd == hd)) { break; }
+        index = (index + 1) & mask;
+    }
+    return(&cSlots[index]);
+}
+
+// Double the table size, rehashing every stored result
+Flag_t HDCacheClass::Grow()
+{
+    // Copy out the results, since the table is rebuilt in the same file
+    const uint32_t oldCount = cHeader->slotCount;
+    vector<HDCacheSlot> saved;
+    for (uint32_t index = 0; index < oldCount; index++)
+    {
+        if (cSlots[index].poly != 0) { saved.push_back(cSlots[index]); }
+    }
+
+    if (!Map(CacheBytes(oldCount * 2))) { Close(); return(0); }
+    memset(cSlots, 0, cBytes - sizeof(HDCacheHeader));
+    cHeader->slotCount = oldCount * 2;
+    for (size_t i = 0; i < saved.size(); i++)
+    {
+        *Slot(saved[i].poly, saved[i].hd) = saved[i];
+    }
+    return(1);
+}
+
+// Look up a result; fills in len and example and returns 1 if cached
+Flag_t HDCacheClass::Find(Poly_t poly, Count_t hd,
+    Length_t &len, UndetectedClass * example)
+{
+    if (!cHeader || (hd >= maxNumWeights)) { return(0); }
+
+    const HDCacheSlot * slot = Slot(poly, hd);
+    if (slot->poly == 0) { return(0); }
+
+    len = slot->len;
+    example->UInit(poly);
+    example->SetFCS(slot->fcs);
+    for (Count_t bitIndex = 0; bitIndex < maxNumWeights; bitIndex++)
+    {
+        example->SetBitPosn(bitIndex, slot->posnList[bitIndex]);
+    }
+    return(1);
+}
+
+// Record a result, replacing any earlier one for the same key
+void HDCacheClass::Store(Poly_t poly, Count_t hd,
+    Length_t len, const UndetectedClass * example)
+{
+    if (!cHeader || (poly == 0) || (hd >= maxNumWeights)) { return; }
+
+    // Keep the table at most half full so probes stay short
+    if ((cHeader->usedCount + 1) * 2 > cHeader->slotCount)
+    {
+        if (!Grow()) { return; }
+    }
+
+    HDCacheSlot * slot = Slot(poly, hd);
+    if (slot->poly == 0) { cHeader->usedCount++; }
+
+    // Fill in the key last so a half-written slot is never found
+    slot->hd = hd;
+    slot->reserved = 0;
+    slot->len = len;
+    slot->fcs = example->GetFCS();
+    for (Count_t bitIndex = 0; bitIndex < maxNumWeights; bitIndex++)
+    {
+        slot->posnList[bitIndex] = example->GetBitPosn(bitIndex);
+    }
+    slot->poly = poly;
+}
+
 ///////////////////// Polynomial Class ////////////////////////////////////////
 
 class CRCpoly{
@@ -310,6 +593,7 @@ private:
     Count_t cNumBitsSet;   // number of bits set in the polynomial
     HDLen * HDArray;               // HDLen array for this poly
     UndetectedClass * Undetected;  // Undetected bit array for this poly
+    HDCacheClass * Cache;          // Stored results; NULL if none
 
     Flag_t CheckAccum(                    // Helper multiple bit FCS detection
         Poly_t accum, Length_t len, Count_t recursionsLeft);
@@ -321,9 +605,32 @@ private:
     Flag_t   FindHDRecurse(               // Dive deep to find HD general case
         Poly_t accumulator, Length_t maxLen, Count_t recursionsLeft);
     Count_t  FindHD(Count_t hdGoal);      // Base case for iteration
+    Flag_t   CachedHD(Count_t hdGoal);    // Report stored result, if any
+    void     ReportHD(                    // Print one HD length and example
+        Count_t hdGoal, Length_t len, UndetectedClass * example);
+
+#ifdef OPTZ   // Single-sweep profile; relies on the optimized shortcuts
+    std::vector<Poly_t>   sResidues;  // FCS of a lone bit at each position
+    std::vector<uint32_t> sFirst;     // hash of first position+1 per residue
+    Length_t sLen;                    // position of the current first bit
+    Count_t  sStartHD;                // lowest HD being profiled
+    Count_t  sTopHD;                  // highest HD not yet resolved
+    Count_t  sBound;                  // heaviest codeword still of interest
+    Length_t sPath[maxNumWeights];    // dataword bits of the current try
+    UndetectedClass * sExamples[maxNumWeights + 1];  // example per HD
+
+    void   SweepHD(Count_t startHD, Count_t maxHD);  // Whole profile
+    void   SweepRecurse(                  // Search more dataword bits
+        Poly_t accum, Length_t maxLen, Count_t dataBits);
+    void   SweepRecord(Poly_t fcs, Count_t dataBits);  // Resolve HDs
+    void   SweepAddResidue(Poly_t residue);          // Extend hash
+    Flag_t SweepFindResidue(                         // Search hash
+        Poly_t residue, Length_t maxLen, Length_t &posn);
+#endif
 
 public:
-    CRCpoly(Poly_t crcPoly);       // Constructor
+    CRCpoly(Poly_t crcPoly,        // Constructor
+        HDCacheClass * cache = 0);
     ~CRCpoly();                    // Destructor; release resources
     inline Poly_t Poly();                 // Retrieve binary polynomial value
     inline Poly_t TopBitSet();            // Retrieve just top bit in poly
@@ -335,8 +642,11 @@ public:
 };
 
 // Constructor. Cache results of characterization of poly and set up lists
-CRCpoly::CRCpoly(Poly_t poly)
+CRCpoly::CRCpoly(Poly_t poly, HDCacheClass * cache)
 {
+    // Cache used to skip searches done before, and to store new results
+    Cache = cache;
+
     // HDArray used to record HD lengths
     HDArray = new HDLen(poly);
     // Undetected array used to record bits in example undetected codeword
@@ -647,7 +957,26 @@ Count_t CRCpoly::FindHD(Count_t hdGoal)
     }
     // Exit loop when first bit has found what we are looking for
     HDArray->SetLen(hdGoal, len);
+    if (Cache) { Cache->Store(Poly(), hdGoal, len, Undetected); }
+    ReportHD(hdGoal, len, Undetected);
+    return(len);
+}
+
+// Report an HD length from the cache instead of searching
+// Return Value: 1 if found and reported; 0 if it must be computed
+Flag_t CRCpoly::CachedHD(Count_t hdGoal)
+{
+    Length_t len;
+    if (!Cache || !Cache->Find(Poly(), hdGoal, len, Undetected)) { return(0); }
 
+    HDArray->SetLen(hdGoal, len);
+    ReportHD(hdGoal, len, Undetected);
+    return(1);
+}
+
+// Print the length found for one HD and the example that violates it
+void CRCpoly::ReportHD(Count_t hdGoal, Length_t len, UndetectedClass * example)
+{
     // zero happens if the very first bit exceeds HD threshold
     cout << "# 0x" << hex << Poly() << dec << "  HD=" << hdGoal;
     if (len == 0)  // Impossible to meet this HD
@@ -661,11 +990,248 @@ Count_t CRCpoly::FindHD(Count_t hdGoal)
 
     // Print the example showing next longer dataword violates HD
     cout << "Example: Len=" << len + 1 << " ";
-    Undetected->SetLen(len + 1);
-    cout << *Undetected << endl;
-    return(len);
+    example->SetLen(len + 1);
+    cout << *example << endl;
+}
+
+
+#ifdef OPTZ   // Only compile if optimizing
+
+///////////////////////// Single-Sweep HD Profile //////////////////////////////
+
+// Calling FindHD once per HD restarts from length zero every time and re-rolls
+//   the same residues at every level.  The sweep instead walks the first
+//   (highest) dataword bit outward once, and at each length looks for the
+//   lightest undetected codeword that could still resolve an HD.  Finding a
+//   codeword of weight w at this length resolves every open HD above w, and
+//   then only lighter codewords remain of interest, so the bound tightens as
+//   the sweep goes and each length costs about as much as the hardest HD
+//   still open.  The full profile costs little more than its slowest level.
+//
+// The same shortcuts as FindHD apply.  The first undetected codeword of any
+//   weight has the top FCS bit set; otherwise shifting it one bit toward the
+//   FCS gives a shorter one of the same weight, which would already have been
+//   found.  So the last dataword bit only needs to leave the top bit, and
+//   a hash from residue to its first position finds that bit in one probe
+//   instead of FindHD4's scan over all shorter positions.
+
+// Residues kept for hash lookups; longer searches roll the rest
+static const Length_t sweepTableMax = 1 << 21;
+
+// Hash a residue for the first-position table
+inline uint32_t SweepHash(Poly_t residue)
+{
+    residue *= 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)(residue >> 32);
+}
+
+// Remember the first position where each residue occurs
+void CRCpoly::SweepAddResidue(Poly_t residue)
+{
+    if (sResidues.size() >= sweepTableMax) { return; }  // past table; roll
+
+    // Keep load at most one half so probes stay short
+    if ((sResidues.size() + 1) * 2 > sFirst.size())
+    {
+        sFirst.assign(sFirst.empty() ? 1024 : sFirst.size() * 2, 0);
+        const uint32_t mask = (uint32_t)sFirst.size() - 1;
+        for (uint32_t posn = 0; posn < sResidues.size(); posn++)
+        {
+            uint32_t slot = SweepHash(sResidues[posn]) & mask;
+            while (sFirst[slot] != 0 && sResidues[sFirst[slot] - 1] != sResidues[posn])
+            {
+                slot = (slot + 1) & mask;
+            }
+            if (sFirst[slot] == 0) { sFirst[slot] = posn + 1; }
+        }
+    }
+
+    const uint32_t mask = (uint32_t)sFirst.size() - 1;
+    uint32_t slot = SweepHash(residue) & mask;
+    while (sFirst[slot] != 0)
+    {   // Residue seen before at a shorter position; keep that one
+        if (sResidues[sFirst[slot] - 1] == residue) { break; }
+        slot = (slot + 1) & mask;
+    }
+    if (sFirst[slot] == 0) { sFirst[slot] = (uint32_t)sResidues.size() + 1; }
+    sResidues.push_back(residue);
+}
+
+// Find a bit position below maxLen whose residue is exactly this value
+// Return Value: 1 with posn set if found; 0 if no such position
+Flag_t CRCpoly::SweepFindResidue(Poly_t residue, Length_t maxLen, Length_t &posn)
+{
+    const uint32_t mask = (uint32_t)sFirst.size() - 1;
+    uint32_t slot = SweepHash(residue) & mask;
+    while (sFirst[slot] != 0)
+    {
+        if (sResidues[sFirst[slot] - 1] == residue)
+        {   // First occurrence; any later one is no better
+            posn = sFirst[slot] - 1;
+            return(posn < maxLen);
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    // Positions past the table are rolled on demand
+    Length_t scanLen = sResidues.size();
+    Poly_t rollingValue = sResidues[scanLen - 1];
+    while (scanLen < maxLen)
+    {
+        rollingValue = RollBy1(rollingValue);
+        if (rollingValue == residue) { posn = scanLen; return(1); }
+        scanLen++;
+    }
+    return(0);
+}
+
+// Record an undetected codeword whose dataword bits are sPath[0..dataBits)
+//   and resolve every open HD that it violates
+void CRCpoly::SweepRecord(Poly_t fcs, Count_t dataBits)
+{
+    const Count_t weight = dataBits + BitCount(fcs);
+    ASSERT(weight < sTopHD, "Codeword should violate an open HD");
+
+    for (Count_t hd = weight + 1; hd <= sTopHD; hd++)
+    {
+        if (hd < sStartHD) { continue; }  // not requested; leave it "?"
+
+        HDArray->SetLen(hd, sLen);
+        UndetectedClass * example = sExamples[hd];
+        example->UInit(Poly());
+        example->SetFCS(fcs);
+        for (Count_t bitIndex = 0; bitIndex < dataBits; bitIndex++)
+        {   // First bit gets the highest index so it prints first
+            example->SetBitPosn(dataBits - bitIndex, sPath[bitIndex]);
+        }
+        if (Cache) { Cache->Store(Poly(), hd, sLen, example); }
+    }
+
+    // Only lighter codewords can resolve the HDs that remain
+    sTopHD = weight;
+    sBound = weight - 1;
+    if (DivXP1() && (sBound & 1))
+    {   // Codewords of a poly divisible by x+1 all have even weight
+        sBound--;
+    }
+}
+
+// Add dataword bits below maxLen to the dataBits already in accum,
+//   looking for any codeword lighter than sBound+1
+void CRCpoly::SweepRecurse(Poly_t accum, Length_t maxLen, Count_t dataBits)
+{
+    Poly_t rollingValue = cPoly;  // rolling a bit at position zero
+    Length_t len = 0;
+
+    for (; len != maxLen; len++, rollingValue = RollBy1(rollingValue))
+    {
+        // Need room for this bit plus at least the top FCS bit
+        if (dataBits + 2 > sBound) { break; }
+
+        const Poly_t newAccum = rollingValue ^ accum;
+        sPath[dataBits] = len;
+
+        if (dataBits + 1 + BitCount(newAccum) <= sBound)
+        {   // Light enough already; record it and keep looking for lighter
+            SweepRecord(newAccum, dataBits + 1);
+        }
+
+        if (dataBits + 3 == sBound)
+        {   // Last bit: must leave exactly the top FCS bit
+            Length_t posn;
+            if (SweepFindResidue(newAccum ^ cTopBitSet, len, posn))
+            {
+                sPath[dataBits + 1] = posn;
+                SweepRecord(cTopBitSet, dataBits + 2);
+            }
+        }
+        else if (dataBits + 3 < sBound)
+        {
+            SweepRecurse(newAccum, len, dataBits + 1);
+        }
+    }
 }
 
+// Compute HD lengths startHD..maxHD in one pass over the first bit position
+void CRCpoly::SweepHD(Count_t startHD, Count_t maxHD)
+{
+    for (Count_t hd = 0; hd <= maxNumWeights; hd++)
+    {
+        sExamples[hd] = new UndetectedClass(Poly());
+    }
+    sResidues.clear();
+    sFirst.clear();
+    sStartHD = startHD;
+    sTopHD = maxHD;
+    sBound = maxHD - 1;
+    if (DivXP1() && (sBound & 1)) { sBound--; }
+
+    Poly_t accum = Poly();  // Accumulator walking first bit error
+    sLen = 0;
+
+    while (sTopHD >= sStartHD)
+    {
+        if (sBound <= 2)
+        {   // Only HD=3 left: a lone bit leaving one FCS bit, as FindHD3
+            while ((accum & (accum - 1)) != 0)
+            {
+                accum = RollBy1(accum);
+                sLen++;
+            }
+            sPath[0] = sLen;
+            SweepRecord(accum, 1);
+            break;
+        }
+
+        // Print out "I'm alive" progress to Stderr; can take a while
+        if ((sLen & 0xFFFF) == 0xFFFF) cerr << "... working; len=" << sLen + 1 << endl;
+
+        SweepAddResidue(accum);
+        sPath[0] = sLen;
+
+        // Does the first bit alone leave few enough FCS bits?
+        if (1 + BitCount(accum) <= sBound)
+        {
+            SweepRecord(accum, 1);
+        }
+
+        if (sBound == 3)
+        {   // Second and last bit must leave exactly the top FCS bit
+            Length_t posn;
+            if (SweepFindResidue(accum ^ cTopBitSet, sLen, posn))
+            {
+                sPath[1] = posn;
+                SweepRecord(cTopBitSet, 2);
+            }
+        }
+        else if (sBound > 3)
+        {
+            SweepRecurse(accum, sLen, 1);
+        }
+
+        if (sTopHD < sStartHD) { break; }
+
+        // advance the first bit further away from the FCS field by 1 bit
+        accum = RollBy1(accum);
+        sLen++;
+    }
+
+    // Report in HD order, as the per-HD search does
+    for (Count_t hd = startHD; hd <= maxHD; hd++)
+    {
+        ReportHD(hd, HDArray->GetLen(hd), sExamples[hd]);
+    }
+
+    for (Count_t hd = 0; hd <= maxNumWeights; hd++)
+    {
+        delete sExamples[hd];
+    }
+    sResidues.clear();
+    sFirst.clear();
+}
+
+#endif // OPTZ
+
 
 // Print selected range of HDs for a polynomial
 void CRCpoly::PolyHD(Poly_t polyx, Count_t startHD, Count_t maxHD)
@@ -683,12 +1249,37 @@ void CRCpoly::PolyHD(Poly_t polyx, Count_t startHD, Count_t maxHD)
     cerr << "Poly=0x" << hex << polyx << dec;
     cerr << " startHD=" << currentHD << " maxHD=" << maxHD << endl;
 
+#ifdef OPTZ
+    // Cached HDs at the low end of the range print at once
+    while ((currentHD <= maxHD) && CachedHD(currentHD))
+    {
+        currentHD++;
+    }
+
+    // Trim cached HDs from the high end, to print after the search
+    Count_t sweepMaxHD = maxHD;
+    Length_t cachedLen;
+    while ((sweepMaxHD >= currentHD) && Cache
+        && Cache->Find(Poly(), sweepMaxHD, cachedLen, Undetected))
+    {
+        sweepMaxHD--;
+    }
+
+    // Find the rest of the requested HD range in one pass
+    if (currentHD <= sweepMaxHD) { SweepHD(currentHD, sweepMaxHD); }
+
+    for (currentHD = sweepMaxHD + 1; currentHD <= maxHD; currentHD++)
+    {
+        CachedHD(currentHD);
+    }
+#else
     // Find HD for requested HD range
     while (currentHD <= maxHD)
     {
-        FindHD(currentHD);
+        if (!CachedHD(currentHD)) { FindHD(currentHD); }
         currentHD++;
     } // end while
+#endif
     // Print summary findings as last item
     cout << *HDArray << endl;
 }
@@ -704,6 +1295,9 @@ int main_1(int argc, char **argv)
     Flag_t useStdin = 0;    // Are we getting inputs from STDIN?
     Flag_t useAutoHD = 0;   // Are we using auto-scaled HD ranges?
 
+    HDCacheClass cache;     // Results from earlier runs
+    HDCacheClass * cacheUsed = 0;
+
     istringstream cmd;      // command line argument stream
     Flag_t failure = 0;     // command line parsing failure if 1
 
@@ -750,6 +1344,15 @@ int main_1(int argc, char **argv)
             << " [poly] | [StartHD MaxHD] | [poly StartHD MaxHD]" << endl;
     }
     else
+    {
+#ifdef OPTZ   // The plain build validates, so it always searches
+        // Check stored results before searching; runs without one if unusable
+        const char * cachePath = getenv("HDLEN_CACHE");
+        if (cachePath && *cachePath && cache.Open(cachePath)) { cacheUsed = &cache; }
+#endif
+    }
+
+    if (!failure)
         do //  do ... while to ensure always process at least one poly if available 
         {
             // Get next polynomial to analyze
@@ -760,7 +1363,7 @@ int main_1(int argc, char **argv)
             }
 
             // do complete computation for one polynomial
-            CRCpoly * Poly = new CRCpoly(p);
+            CRCpoly * Poly = new CRCpoly(p, cacheUsed);
             Poly->PolyHD(p, startHD, maxHD);
             delete Poly;
         } while ((!feof(stdin)) && useStdin);   // end while